@@ -6,6 +6,7 @@
 #include "User.h"
 #include <vector>
 #include <string>
+#include <string_view>
 #include "../include/Admin.h"
 #include "../include/GlobalVariables.h"
 
@@ -16,6 +17,8 @@ class Lecturer;
 class Room;
 class SessionType;
 class TimetableManager;
+class UserManager;
+class WeekSet;
 
 /**
  * @class Admin
@@ -26,7 +29,7 @@ class TimetableManager;
  */
 class Admin : public User {
 private:
-    std::string department;
+    StringInterner::Symbol department;
 
 public:
     /**
@@ -48,7 +51,7 @@ public:
      * @brief Gets the admin's department
      * @return Department string
      */
-    std::string getDepartment() const;
+    std::string_view getDepartment() const;
 
     /**
      * @brief Creates a new module
@@ -77,6 +80,7 @@ public:
 
     /**
      * @brief Registers a new student
+     * @param userManager Users the student ID must not clash with
      * @param id Student ID
      * @param name Student's name
      * @param pwd Student's password
@@ -84,8 +88,8 @@ public:
      * @param course Student's course
      * @return Pointer to the created student or nullptr if registration failed
      */
-    Student* registerStudent(const std::string& id, const std::string& name, const std::string& pwd,
-                           const std::string& studentNumber, const std::string& course);
+    Student* registerStudent(const UserManager& userManager, const std::string& id, const std::string& name,
+                           const std::string& pwd, const std::string& studentNumber, const std::string& course);
 
     /**
      * @brief Assigns a student to a group
@@ -93,7 +97,7 @@ public:
      * @param groupID ID of the group
      * @return True if assignment successful, false otherwise
      */
-    bool assignStudentToGroup(const std::string& studentID, const std::string& groupID);
+    bool assignStudentToGroup(std::string_view studentID, std::string_view groupID);
 
     /**
      * @brief Registers a new lecturer
@@ -110,7 +114,7 @@ public:
      * @param moduleCode Code of the module
      * @return True if assignment successful, false otherwise
      */
-    bool assignLecturerToModule(const std::string& lecturerID, const std::string& moduleCode);
+    bool assignLecturerToModule(std::string_view lecturerID, std::string_view moduleCode);
 
     /**
      * @brief Adds a new room
@@ -122,9 +126,9 @@ public:
     bool addRoom(const std::string& roomID, const std::string& location, int capacity);
 
     /**
-     * @brief Creates a timetable entry
+     * @brief Creates a timetable entry running in one or more weeks
      * @param timetableManager Reference to the timetable manager
-     * @param week Week number
+     * @param weeks Weeks the session runs in
      * @param moduleCode Module code
      * @param lecturerID Lecturer ID
      * @param roomID Room ID
@@ -135,10 +139,10 @@ public:
      * @param endTime End time
      * @return True if timetable entry created successfully, false otherwise
      */
-    bool createTimetableEntry(TimetableManager& timetableManager, int week,
-                             const std::string& moduleCode, const std::string& lecturerID,
-                             const std::string& roomID, const std::string& groupID,
-                             const std::string& sessionTypeID, const std::string& day,
+    bool createTimetableEntry(TimetableManager& timetableManager, const WeekSet& weeks,
+                             std::string_view moduleCode, std::string_view lecturerID,
+                             std::string_view roomID, std::string_view groupID,
+                             std::string_view sessionTypeID, const std::string& day,
                              const std::string& startTime, const std::string& endTime);
 
     /**
@@ -0,0 +1,103 @@
+
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "UserManager.h"
+#include "TimetableManager.h"
+
+/**
+ * @struct BatchSummary
+ * @brief Outcome of a batch run
+ */
+struct BatchSummary {
+    size_t commandsRun = 0;
+    size_t commandsFailed = 0;      // Unknown commands, bad arguments and operations that were refused
+    size_t conflicts = 0;           // Conflicts found by the final check
+};
+
+/**
+ * @class BatchRunner
+ * @brief Runs a script of timetabling commands without the interactive menus
+ *
+ * A script has one command per line: a command name followed by its
+ * arguments, separated by spaces. Arguments containing spaces are written
+ * in double quotes, and lines starting with # are comments. Commands map
+ * onto the Admin, UserManager and TimetableManager operations, and most of
+ * them need a login command first. A failed command is reported with its
+ * line number and the script carries on. Console output is collected in a
+ * large block and written out only when the block is full or the run ends,
+ * and conflicts are rescanned once after the last command. The help
+ * command lists the commands.
+ */
+class BatchRunner {
+private:
+    UserManager& userManager;
+    TimetableManager& timetableManager;
+    std::string snapshotFile;       // Target of journal compaction between commands
+    Admin* admin;                   // Admin the script logged in as, nullptr until then
+
+    using Arguments = std::vector<std::string>;
+
+    // A command's argument limits, whether it needs a logged in admin, and its handler
+    struct Command {
+        std::string_view name;
+        size_t minArguments;
+        size_t maxArguments;
+        bool adminOnly;
+        bool (BatchRunner::*run)(const Arguments& args);
+        std::string_view usage;
+    };
+
+    static const Command COMMANDS[];
+
+    // Helper function to split a line into words, keeping quoted text together
+    static bool splitLine(std::string_view line, Arguments& words);
+
+    // Command handlers; each returns false if the operation failed or was refused
+    bool login(const Arguments& args);
+    bool registerAdmin(const Arguments& args);
+    bool registerStudent(const Arguments& args);
+    bool deleteUser(const Arguments& args);
+    bool createModule(const Arguments& args);
+    bool createGroup(const Arguments& args);
+    bool defineSessionType(const Arguments& args);
+    bool registerLecturer(const Arguments& args);
+    bool assignLecturer(const Arguments& args);
+    bool assignStudent(const Arguments& args);
+    bool addRoom(const Arguments& args);
+    bool createEntry(const Arguments& args);
+    bool deleteEntry(const Arguments& args);
+    bool importCSV(const Arguments& args);
+    bool exportCSV(const Arguments& args);
+    bool showTimetable(const Arguments& args);
+    bool search(const Arguments& args);
+    bool checkConflicts(const Arguments& args);
+    bool verifyConflicts(const Arguments& args);
+    bool checkSweep(const Arguments& args);
+    bool echo(const Arguments& args);
+    bool help(const Arguments& args);
+
+public:
+    /**
+     * @brief Constructor for BatchRunner class
+     * @param users User manager the commands act on
+     * @param timetable Timetable manager the commands act on
+     * @param snapshot Snapshot file the journal is compacted into between commands
+     */
+    BatchRunner(UserManager& users, TimetableManager& timetable, const std::string& snapshot);
+
+    /**
+     * @brief Runs every command of a script
+     * @param script Script to read commands from
+     * @param summary Optional counts of commands run and failed and of conflicts found
+     * @return True if every command succeeded, false otherwise
+     */
+    bool run(std::istream& script, BatchSummary* summary = nullptr);
+};
+
+#endif // BATCH_RUNNER_H
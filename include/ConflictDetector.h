@@ -3,10 +3,36 @@
 #ifndef CONFLICT_DETECTOR_H
 #define CONFLICT_DETECTOR_H
 
+#include <cstdint>
+#include <span>
 #include <vector>
 #include <string>
 #include <utility>
+#include <unordered_map>
+#include <unordered_set>
 #include "TimetableEntry.h"
+#include "EntryColumns.h"
+
+/**
+ * @struct Conflict
+ * @brief A clash between two timetable entries and why they clash
+ */
+struct Conflict {
+    // Resources two clashing entries can share; a conflict may have several
+    enum Kind : std::uint8_t {
+        RoomClash = 1,
+        LecturerClash = 2,
+        GroupClash = 4
+    };
+
+    TimetableEntry* first;          // The entry added earlier
+    TimetableEntry* second;         // The entry added later
+    std::uint16_t overlapStart;     // Minutes since midnight at which both sessions are running
+    std::uint16_t overlapEnd;       // Minutes since midnight at which the first of them ends, never before overlapStart
+    std::uint8_t kinds;             // Bitmask of Kind values
+
+    bool operator==(const Conflict& other) const = default;
+};
 
 /**
  * @class ConflictDetector
@@ -19,7 +45,59 @@
 class ConflictDetector {
 private:
     std::vector<std::string> conflictTypes;
-    std::vector<std::pair<TimetableEntry*, TimetableEntry*>> conflicts;
+
+    // Every current conflict, each built once when it was found; removing one
+    // moves the last conflict into its place
+    std::vector<Conflict> conflicts;
+
+    // Tracked entries in each (day, resource) bucket, keyed by bucketKey; an entry
+    // running in several weeks is tracked once, and week masks are compared when probing
+    std::unordered_map<std::uint64_t, std::vector<TimetableEntry*>> roomBuckets;
+    std::unordered_map<std::uint64_t, std::vector<TimetableEntry*>> lecturerBuckets;
+    std::unordered_map<std::uint64_t, std::vector<TimetableEntry*>> groupBuckets;
+
+    // Tracked entries, and the positions in conflicts of the conflicts each entry is part of
+    std::unordered_set<TimetableEntry*> tracked;
+    std::unordered_map<TimetableEntry*, std::vector<size_t>> clashes;
+    size_t kindCounts[3];           // Conflicts involving a shared room, lecturer and group
+
+    // Builds the conflict record of two clashing entries
+    static Conflict makeConflict(TimetableEntry* first, TimetableEntry* second);
+
+    // Helper function to add to, or with -1 subtract from, the per-kind counts
+    void countKinds(std::uint8_t kinds, int delta);
+
+    // Builds the key of an entry's (day, resource) bucket from the resource's symbol
+    static std::uint64_t bucketKey(const TimetableEntry& entry, StringInterner::Symbol resource);
+
+    // Adds an entry to its room, lecturer and group buckets
+    void trackEntry(TimetableEntry* entry);
+
+    // Records a conflict between two tracked entries
+    void addConflict(const Conflict& conflict);
+
+    // Drops the conflict at a position in conflicts, moving the last conflict into its place
+    void removeConflict(size_t position);
+
+    // Helper function to replace, or with SIZE_MAX drop, a position in an entry's list of conflicts
+    void relink(TimetableEntry* entry, size_t from, size_t to);
+
+    // Runs the sweep over all rows on up to threads threads and returns row pairs in pairwise scan order
+    std::vector<std::pair<size_t, size_t>> sweepConflicts(const EntryColumns& columns, unsigned int threads) const;
+
+    // An entry's row together with the dense ID of the resource being swept, its week mask and start and end minutes
+    struct SweepItem {
+        size_t index;
+        std::uint32_t resource;
+        std::uint64_t weeks;
+        int start;
+        int end;
+    };
+
+    // Sweeps the rows sharing each resource in start time order and appends row pairs of conflicting entries
+    void sweepResources(const EntryColumns& columns,
+                        std::vector<SweepItem>& items,
+                        std::vector<std::pair<size_t, size_t>>& found) const;
 
 public:
     /**
@@ -29,9 +107,68 @@ public:
 
     /**
      * @brief Detects conflicts in a set of timetable entries
+     *
+     * Rows are bucketed by day, and each bucket is swept in start time order
+     * per room, per lecturer and per student group; overlapping sessions only
+     * clash if their week masks intersect, so an entry running in many weeks
+     * is swept once rather than once per week. The cost grows with n log n
+     * plus the number of overlaps. The sweep reads only the week, day, time
+     * and dense ID columns. Each (day, kind of resource) is independent, and
+     * with several threads these are split further by dense ID and shared
+     * out among a thread pool. Pairs are reported in the same order as
+     * findConflictsPairwise whatever the thread count. This is a full
+     * rescan: the incrementally maintained state is discarded and rebuilt
+     * from the given entries.
+     *
+     * @param columns Timetable entries to check, one row each
+     * @param threads Most threads to sweep on; small timetables are always swept on the calling thread
+     */
+    void detectConflicts(const EntryColumns& columns, unsigned int threads = 1);
+
+    /**
+     * @brief Starts tracking a new entry and records the conflicts it causes
+     *
+     * Only entries sharing the new entry's day and its room, lecturer or
+     * student group are probed, and of those only the ones whose week mask
+     * intersects its own can clash.
+     *
+     * @param entry Pointer to the entry that was added to the timetable
+     */
+    void addEntry(TimetableEntry* entry);
+
+    /**
+     * @brief Stops tracking an entry and drops the conflicts involving it
+     * @param entry Pointer to the entry that is being removed from the timetable
+     */
+    void removeEntry(TimetableEntry* entry);
+
+    /**
+     * @brief Verifies the maintained conflicts against a full rescan
+     * @param columns All timetable entries, one row each in insertion order
+     * @return True if the maintained conflicts match a full rescan, false otherwise
+     */
+    bool verifyConflicts(const EntryColumns& columns) const;
+
+    /**
+     * @brief Reference implementation comparing every pair of entries
      * @param entries Vector of pointers to timetable entries to check
+     * @return Conflicts between the entries, in the order a full rescan lists them
      */
-    void detectConflicts(const std::vector<TimetableEntry*>& entries);
+    std::vector<Conflict> findConflictsPairwise(const std::vector<TimetableEntry*>& entries) const;
+
+    /**
+     * @brief Checks the sweep against findConflictsPairwise
+     *
+     * The sweep runs once on a single thread and once on up to threads
+     * threads, and each run must report exactly the pairwise scan's
+     * conflicts in the same order. The pairwise scan takes time quadratic
+     * in the number of entries. The maintained conflicts are not used or changed.
+     *
+     * @param columns Entries to check, one row each
+     * @param threads Most threads for the second run
+     * @return True if both runs match the pairwise scan, false otherwise
+     */
+    bool checkSweep(const EntryColumns& columns, unsigned int threads) const;
 
     /**
      * @brief Checks if any conflicts were detected
@@ -41,16 +178,29 @@ public:
 
     /**
      * @brief Gets all detected conflicts
-     * @return Vector of pairs of conflicting timetable entries
+     *
+     * The conflicts are not copied; the view stays valid until the next
+     * entry is added or removed or the timetable is rescanned. A full rescan
+     * lists them ordered by the entries' insertion order; later conflicts
+     * are appended, and removing one moves the last into its place.
+     *
+     * @return Conflicts found so far
+     */
+    std::span<const Conflict> getConflicts() const;
+
+    /**
+     * @brief Gets the number of conflicts involving one kind of shared resource
+     * @param kind Kind of resource
+     * @return Number of conflicts with that kind among their kinds
      */
-    std::vector<std::pair<TimetableEntry*, TimetableEntry*>> getConflicts() const;
+    size_t getConflictCount(Conflict::Kind kind) const;
 
     /**
      * @brief Suggests a resolution for a conflict
-     * @param conflict Pair of conflicting timetable entries
+     * @param conflict Conflict between two timetable entries
      * @return String containing suggested resolution
      */
-    std::string suggestResolution(const std::pair<TimetableEntry*, TimetableEntry*>& conflict) const;
+    std::string suggestResolution(const Conflict& conflict) const;
 };
 
 #endif // CONFLICT_DETECTOR_H
\ No newline at end of file
@@ -0,0 +1,310 @@
+
+
+#ifndef ENTITY_REGISTRY_H
+#define ENTITY_REGISTRY_H
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "FlatIndex.h"
+#include "Module.h"
+#include "Lecturer.h"
+#include "Room.h"
+#include "SessionType.h"
+#include "StudentGroup.h"
+#include "Student.h"
+
+/**
+ * @class EntityTable
+ * @brief Owns the entities of one kind, in insertion order and indexed by ID
+ *
+ * The ordered list is what menus number and iterate; the index answers
+ * lookups by ID in constant time. Entities are heap objects that never move,
+ * so pointers to them stay valid until they are removed.
+ */
+template <typename T>
+class EntityTable {
+private:
+    std::vector<T*> items;
+    FlatIndex<T*> index;
+
+public:
+    EntityTable() = default;
+    EntityTable(const EntityTable&) = delete;
+    EntityTable& operator=(const EntityTable&) = delete;
+
+    ~EntityTable() {
+        clear();
+    }
+
+    T* find(std::string_view id) const {
+        T* const* found = index.find(id);
+        return found ? *found : nullptr;
+    }
+
+    // Takes ownership of item if its ID is not already taken
+    bool add(std::string_view id, T* item) {
+        if (!index.insert(id, item)) {
+            return false;
+        }
+        items.push_back(item);
+        return true;
+    }
+
+    // Deletes the entity with the given ID
+    bool remove(std::string_view id) {
+        T* item = find(id);
+        if (!item) {
+            return false;
+        }
+        index.erase(id);
+        items.erase(std::find(items.begin(), items.end(), item));
+        delete item;
+        return true;
+    }
+
+    void reserve(size_t count) {
+        items.reserve(count);
+        index.reserve(count);
+    }
+
+    void clear() {
+        for (auto item : items) {
+            delete item;
+        }
+        items.clear();
+        index.clear();
+    }
+
+    const std::vector<T*>& getItems() const {
+        return items;
+    }
+};
+
+/**
+ * @class EntityRegistry
+ * @brief Owns every module, lecturer, room, student group, session type and student
+ *
+ * Each kind is kept in creation order for listing and in a flat hash index
+ * for lookup by ID, so finding an entity no longer scans every entity of
+ * its kind and adding one no longer scans for duplicates. Students are the
+ * single store behind both UserManager and the admin operations, and are
+ * also indexed by student number.
+ */
+class EntityRegistry {
+private:
+    EntityTable<Module> modules;
+    EntityTable<Lecturer> lecturers;
+    EntityTable<Room> rooms;
+    EntityTable<SessionType> sessionTypes;
+    EntityTable<StudentGroup> studentGroups;
+    EntityTable<Student> students;
+    FlatIndex<Student*> studentsByNumber;
+
+public:
+    /**
+     * @brief Constructor for EntityRegistry class
+     */
+    EntityRegistry();
+
+    /**
+     * @brief Destructor, deletes every entity still registered
+     */
+    ~EntityRegistry();
+
+    EntityRegistry(const EntityRegistry&) = delete;
+    EntityRegistry& operator=(const EntityRegistry&) = delete;
+
+    /**
+     * @brief Finds a module by code
+     * @param code Module code
+     * @return Pointer to the module, or nullptr if not found
+     */
+    Module* findModule(std::string_view code) const;
+
+    /**
+     * @brief Finds a lecturer by ID
+     * @param id Lecturer ID
+     * @return Pointer to the lecturer, or nullptr if not found
+     */
+    Lecturer* findLecturer(std::string_view id) const;
+
+    /**
+     * @brief Finds a room by ID
+     * @param id Room ID
+     * @return Pointer to the room, or nullptr if not found
+     */
+    Room* findRoom(std::string_view id) const;
+
+    /**
+     * @brief Finds a session type by ID
+     * @param id Session type ID
+     * @return Pointer to the session type, or nullptr if not found
+     */
+    SessionType* findSessionType(std::string_view id) const;
+
+    /**
+     * @brief Finds a student group by ID
+     * @param id Group ID
+     * @return Pointer to the group, or nullptr if not found
+     */
+    StudentGroup* findStudentGroup(std::string_view id) const;
+
+    /**
+     * @brief Finds a student by user ID
+     * @param id Student user ID
+     * @return Pointer to the student, or nullptr if not found
+     */
+    Student* findStudent(std::string_view id) const;
+
+    /**
+     * @brief Finds a student by student number
+     * @param studentNumber Student registration number
+     * @return Pointer to the student, or nullptr if not found
+     */
+    Student* findStudentByNumber(std::string_view studentNumber) const;
+
+    /**
+     * @brief Registers a module, taking ownership of it
+     * @param module Module to register
+     * @return True if registered, false if its code is already taken
+     */
+    bool addModule(Module* module);
+
+    /**
+     * @brief Registers a lecturer, taking ownership of it
+     * @param lecturer Lecturer to register
+     * @return True if registered, false if its ID is already taken
+     */
+    bool addLecturer(Lecturer* lecturer);
+
+    /**
+     * @brief Registers a room, taking ownership of it
+     * @param room Room to register
+     * @return True if registered, false if its ID is already taken
+     */
+    bool addRoom(Room* room);
+
+    /**
+     * @brief Registers a session type, taking ownership of it
+     * @param sessionType Session type to register
+     * @return True if registered, false if its ID is already taken
+     */
+    bool addSessionType(SessionType* sessionType);
+
+    /**
+     * @brief Registers a student group, taking ownership of it
+     * @param group Group to register
+     * @return True if registered, false if its ID is already taken
+     */
+    bool addStudentGroup(StudentGroup* group);
+
+    /**
+     * @brief Registers a student, taking ownership of it
+     *
+     * Only the user ID has to be unique; callers that also require a unique
+     * student number check findStudentByNumber first.
+     *
+     * @param student Student to register
+     * @return True if registered, false if its user ID is already taken
+     */
+    bool addStudent(Student* student);
+
+    /**
+     * @brief Removes and deletes a module
+     * @param code Module code
+     * @return True if the module was found and removed, false otherwise
+     */
+    bool removeModule(std::string_view code);
+
+    /**
+     * @brief Removes and deletes a lecturer
+     * @param id Lecturer ID
+     * @return True if the lecturer was found and removed, false otherwise
+     */
+    bool removeLecturer(std::string_view id);
+
+    /**
+     * @brief Removes and deletes a room
+     * @param id Room ID
+     * @return True if the room was found and removed, false otherwise
+     */
+    bool removeRoom(std::string_view id);
+
+    /**
+     * @brief Removes and deletes a session type
+     * @param id Session type ID
+     * @return True if the session type was found and removed, false otherwise
+     */
+    bool removeSessionType(std::string_view id);
+
+    /**
+     * @brief Removes and deletes a student group
+     * @param id Group ID
+     * @return True if the group was found and removed, false otherwise
+     */
+    bool removeStudentGroup(std::string_view id);
+
+    /**
+     * @brief Removes and deletes a student, taking it out of its groups
+     * @param id Student user ID
+     * @return True if the student was found and removed, false otherwise
+     */
+    bool removeStudent(std::string_view id);
+
+    /**
+     * @brief Gets all modules in creation order
+     * @return Vector of module pointers
+     */
+    const std::vector<Module*>& getModules() const;
+
+    /**
+     * @brief Gets all lecturers in creation order
+     * @return Vector of lecturer pointers
+     */
+    const std::vector<Lecturer*>& getLecturers() const;
+
+    /**
+     * @brief Gets all rooms in creation order
+     * @return Vector of room pointers
+     */
+    const std::vector<Room*>& getRooms() const;
+
+    /**
+     * @brief Gets all session types in creation order
+     * @return Vector of session type pointers
+     */
+    const std::vector<SessionType*>& getSessionTypes() const;
+
+    /**
+     * @brief Gets all student groups in creation order
+     * @return Vector of group pointers
+     */
+    const std::vector<StudentGroup*>& getStudentGroups() const;
+
+    /**
+     * @brief Gets all students in registration order
+     * @return Vector of student pointers
+     */
+    const std::vector<Student*>& getStudents() const;
+
+    /**
+     * @brief Makes room for a number of entities of each kind, for bulk loads
+     * @param moduleCount Modules expected
+     * @param lecturerCount Lecturers expected
+     * @param roomCount Rooms expected
+     * @param sessionTypeCount Session types expected
+     * @param groupCount Student groups expected
+     * @param studentCount Students expected
+     */
+    void reserve(size_t moduleCount, size_t lecturerCount, size_t roomCount,
+                 size_t sessionTypeCount, size_t groupCount, size_t studentCount);
+
+    /**
+     * @brief Deletes every registered entity
+     */
+    void clear();
+};
+
+#endif // ENTITY_REGISTRY_H
@@ -0,0 +1,247 @@
+
+
+#ifndef ENTRY_COLUMNS_H
+#define ENTRY_COLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "StringInterner.h"
+#include "TimetableEntry.h"
+
+/**
+ * @class EntryColumns
+ * @brief Timetable entries stored column by column for fast scans
+ *
+ * Row i describes the i-th entry in creation order. Besides the entry
+ * pointers there is one array per field: week mask, day, start and end minutes,
+ * and a dense integer ID for the room, lecturer, student group, module and
+ * session type. Dense IDs are handed out per kind the first time an ID's
+ * symbol is seen and never reused, so two rows share a dense ID exactly when
+ * they share the ID. Filters and the conflict sweep then read a few
+ * small arrays front to back instead of following pointers per entry.
+ *
+ * Rows are stored in fixed-size chunks held by shared pointers, and the
+ * dense ID tables likewise. Copying the columns copies only the pointers;
+ * the copy that changes a shared chunk afterwards copies that chunk
+ * first, so publishing a version after an edit costs the chunks the edit
+ * touched rather than every row.
+ */
+class EntryColumns {
+public:
+    /**
+     * @brief Kinds of referenced entity that get dense IDs
+     */
+    enum class Key { Room, Lecturer, Group, Module, SessionType };
+
+    /**
+     * @brief Filter value matching every dense ID
+     */
+    static constexpr std::uint32_t ANY = 0xFFFFFFFF;
+
+    /**
+     * @brief Dense ID returned for an ID string no entry has used; matches no row
+     */
+    static constexpr std::uint32_t UNKNOWN = 0xFFFFFFFE;
+
+    /**
+     * @struct Filter
+     * @brief Criteria for select; every field left at its default matches all rows
+     */
+    struct Filter {
+        int week = -1;
+        std::uint32_t module = ANY;
+        std::uint32_t room = ANY;
+        std::uint32_t lecturer = ANY;
+        std::uint32_t group = ANY;
+    };
+
+    /**
+     * @brief Rows per chunk of storage
+     */
+    static constexpr size_t CHUNK_ROWS = 512;
+
+private:
+    // Dense IDs per chunk of the symbol tables
+    static constexpr size_t ID_CHUNK_SYMBOLS = 1024;
+
+    // Chunks are shared between copies and copied by the first change after a copy;
+    // a chunk stamped with the epoch passed to append or erase may be changed in place
+    struct Chunk {
+        std::uint64_t epoch;
+        TimetableEntry* entries[CHUNK_ROWS];    // nullptr in an erased row
+        std::uint64_t weeks[CHUNK_ROWS];        // Week masks, bit w set for week w; 0 in an erased row
+        std::uint8_t days[CHUNK_ROWS];
+        std::uint16_t starts[CHUNK_ROWS];       // Minutes since midnight
+        std::uint16_t ends[CHUNK_ROWS];         // Minutes since midnight
+        std::uint32_t ids[5][CHUNK_ROWS];       // Dense IDs, one array per Key
+    };
+
+    struct IDChunk {
+        std::uint64_t epoch;
+        std::uint32_t ids[ID_CHUNK_SYMBOLS];    // Dense ID of each symbol in the chunk; UNKNOWN where unused
+    };
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    size_t rowCount = 0;                        // Rows in use, erased ones included
+    size_t erasedCount = 0;
+
+    // Dense ID of each ID symbol, one chunked table per Key indexed by symbol
+    std::vector<std::shared_ptr<IDChunk>> denseIDs[5];
+    std::uint32_t denseCounts[5] = {};
+
+    // Helper function to get a chunk this copy may change, copying it if it is shared
+    template <typename Node>
+    static Node& own(std::shared_ptr<Node>& node, std::uint64_t epoch);
+
+    // Helper function to get the dense ID of an ID symbol, handing out the next one if it is new
+    std::uint32_t intern(Key key, StringInterner::Symbol id, std::uint64_t epoch);
+
+    // Helper function to rewrite the live rows into fresh chunks, dropping erased rows
+    void compact(std::uint64_t epoch);
+
+public:
+    /**
+     * @brief Appends a row for a new entry
+     * @param entry Entry to append
+     * @param epoch Epoch of the owning version; chunks stamped with another epoch are copied before changing
+     */
+    void append(TimetableEntry* entry, std::uint64_t epoch);
+
+    /**
+     * @brief Erases a row
+     *
+     * The row is left empty and skipped by select and the conflict sweep, so
+     * only its chunk changes. Once more than half the rows are erased the
+     * live rows are moved down into fresh chunks, which renumbers them.
+     *
+     * @param row Row to erase
+     * @param epoch Epoch of the owning version; chunks stamped with another epoch are copied before changing
+     */
+    void erase(size_t row, std::uint64_t epoch);
+
+    /**
+     * @brief Makes room for a number of rows
+     * @param rows Rows expected
+     */
+    void reserve(size_t rows);
+
+    /**
+     * @brief Removes every row and forgets all dense IDs
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of rows
+     * @return Number of rows, erased ones included; every row index is below it
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the number of entries
+     * @return Number of rows that are not erased
+     */
+    size_t count() const;
+
+    /**
+     * @brief Finds the row of an entry
+     *
+     * Each entry records the row it was last given, so this takes constant
+     * time; it answers for the columns that last appended or compacted the entry.
+     *
+     * @param entry Entry to look for
+     * @return Row holding the entry, or size() if there is none
+     */
+    size_t findRow(const TimetableEntry* entry) const;
+
+    /**
+     * @brief Looks up the dense ID of an ID
+     * @param key Kind of entity the ID belongs to
+     * @param id Symbol of the room ID, lecturer ID, group ID, module code or session type ID
+     * @return Dense ID, or UNKNOWN if no entry has used the ID
+     */
+    std::uint32_t findID(Key key, StringInterner::Symbol id) const;
+
+    /**
+     * @brief Gets the number of dense IDs handed out for a kind
+     * @param key Kind of entity
+     * @return Number of dense IDs; every ID in the column is below it
+     */
+    size_t idCount(Key key) const;
+
+    /**
+     * @brief Finds the rows matching a filter
+     *
+     * Rows are tested a chunk at a time: each criterion is one branch-free
+     * pass over its column that compilers turn into vector compares, and
+     * the matches of the chunk are then gathered into rows.
+     *
+     * @param filter Criteria to match; a week matches every row running in it
+     * @param rows Set to the matching rows, in ascending order; erased rows never match
+     */
+    void select(const Filter& filter, std::vector<std::uint32_t>& rows) const;
+
+    /**
+     * @brief Gets the entries
+     * @return Vector of entry pointers in creation order, without erased rows
+     */
+    std::vector<TimetableEntry*> getEntries() const;
+
+    /**
+     * @brief Gets the entry of a row
+     * @param row Row below size()
+     * @return Entry pointer, or nullptr if the row is erased
+     */
+    TimetableEntry* getEntry(size_t row) const {
+        return chunks[row / CHUNK_ROWS]->entries[row % CHUNK_ROWS];
+    }
+
+    /**
+     * @brief Gets the week mask of a row
+     * @param row Row below size()
+     * @return Weeks as WeekSet bits; 0 if the row is erased
+     */
+    std::uint64_t getWeeks(size_t row) const {
+        return chunks[row / CHUNK_ROWS]->weeks[row % CHUNK_ROWS];
+    }
+
+    /**
+     * @brief Gets the day of a row
+     * @param row Row below size()
+     * @return Day of the week as a TimeSlot::Day value
+     */
+    std::uint8_t getDay(size_t row) const {
+        return chunks[row / CHUNK_ROWS]->days[row % CHUNK_ROWS];
+    }
+
+    /**
+     * @brief Gets the start time of a row
+     * @param row Row below size()
+     * @return Start time in minutes since midnight
+     */
+    std::uint16_t getStart(size_t row) const {
+        return chunks[row / CHUNK_ROWS]->starts[row % CHUNK_ROWS];
+    }
+
+    /**
+     * @brief Gets the end time of a row
+     * @param row Row below size()
+     * @return End time in minutes since midnight
+     */
+    std::uint16_t getEnd(size_t row) const {
+        return chunks[row / CHUNK_ROWS]->ends[row % CHUNK_ROWS];
+    }
+
+    /**
+     * @brief Gets a dense ID of a row
+     * @param key Kind of entity
+     * @param row Row below size()
+     * @return Dense ID of that entity
+     */
+    std::uint32_t getID(Key key, size_t row) const {
+        return chunks[row / CHUNK_ROWS]->ids[static_cast<int>(key)][row % CHUNK_ROWS];
+    }
+};
+
+#endif // ENTRY_COLUMNS_H
@@ -0,0 +1,168 @@
+
+
+#ifndef FLAT_INDEX_H
+#define FLAT_INDEX_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class FlatIndex
+ * @brief Open-addressing hash map from string IDs to values
+ *
+ * Entries live in one flat array and collisions are resolved by linear
+ * probing, so a lookup is a hash plus a short scan of adjacent slots rather
+ * than a walk through per-bucket nodes. Each slot keeps its full hash, so
+ * keys are only compared when the hashes match. Erasing shifts the rest of
+ * the probe run back instead of leaving tombstones. Lookups take a
+ * string_view and never allocate.
+ */
+template <typename V>
+class FlatIndex {
+private:
+    struct Slot {
+        std::string key;
+        V value{};
+        size_t hash = 0;
+        bool used = false;
+    };
+
+    std::vector<Slot> slots;  // Size is zero or a power of two
+    size_t count;
+
+    static size_t hashOf(std::string_view key) {
+        return std::hash<std::string_view>()(key);
+    }
+
+    // Helper function to find the slot holding a key, or the empty slot ending its probe run
+    size_t probe(std::string_view key, size_t hash) const {
+        size_t mask = slots.size() - 1;
+        size_t i = hash & mask;
+        while (slots[i].used && (slots[i].hash != hash || slots[i].key != key)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    // Helper function to move every entry into a table of the given size
+    void rehash(size_t capacity) {
+        std::vector<Slot> old(capacity);
+        old.swap(slots);
+        for (auto& slot : old) {
+            if (slot.used) {
+                slots[probe(slot.key, slot.hash)] = std::move(slot);
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor for FlatIndex class
+     */
+    FlatIndex() : count(0) {
+    }
+
+    /**
+     * @brief Finds the value stored for a key
+     * @param key Key to look up
+     * @return Pointer to the value, or nullptr if the key is not present
+     */
+    const V* find(std::string_view key) const {
+        if (count == 0) {
+            return nullptr;
+        }
+        const Slot& slot = slots[probe(key, hashOf(key))];
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    /**
+     * @brief Adds a key and its value
+     * @param key Key to add
+     * @param value Value to store
+     * @return True if added, false if the key is already present
+     */
+    bool insert(std::string_view key, V value) {
+        // Keep the table at most three quarters full so probe runs stay short
+        if ((count + 1) * 4 > slots.size() * 3) {
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        }
+
+        size_t hash = hashOf(key);
+        Slot& slot = slots[probe(key, hash)];
+        if (slot.used) {
+            return false;
+        }
+        slot.key = key;
+        slot.value = std::move(value);
+        slot.hash = hash;
+        slot.used = true;
+        ++count;
+        return true;
+    }
+
+    /**
+     * @brief Removes a key
+     * @param key Key to remove
+     * @return True if the key was present, false otherwise
+     */
+    bool erase(std::string_view key) {
+        if (count == 0) {
+            return false;
+        }
+
+        size_t mask = slots.size() - 1;
+        size_t hole = probe(key, hashOf(key));
+        if (!slots[hole].used) {
+            return false;
+        }
+
+        // Pull later entries of the probe run back into the hole when their home allows it
+        for (size_t next = (hole + 1) & mask; slots[next].used; next = (next + 1) & mask) {
+            size_t home = slots[next].hash & mask;
+            bool homeBetween = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+            if (!homeBetween) {
+                slots[hole] = std::move(slots[next]);
+                hole = next;
+            }
+        }
+        slots[hole] = Slot();
+        --count;
+        return true;
+    }
+
+    /**
+     * @brief Makes room for a number of keys without further rehashing
+     * @param keys Number of keys expected
+     */
+    void reserve(size_t keys) {
+        size_t capacity = slots.empty() ? 16 : slots.size();
+        while (keys * 4 > capacity * 3) {
+            capacity *= 2;
+        }
+        if (capacity > slots.size()) {
+            rehash(capacity);
+        }
+    }
+
+    /**
+     * @brief Removes every key
+     */
+    void clear() {
+        slots.clear();
+        count = 0;
+    }
+
+    /**
+     * @brief Gets the number of keys stored
+     * @return Number of keys
+     */
+    size_t size() const {
+        return count;
+    }
+};
+
+#endif // FLAT_INDEX_H
@@ -9,13 +9,25 @@
 #include "Room.h"
 #include "SessionType.h"
 #include "StudentGroup.h"
+#include "EntityRegistry.h"
+#include "Journal.h"
+#include "StringInterner.h"
 
-// Declare external variables
-extern std::vector<Module*> g_modules;
-extern std::vector<Student*> g_students;
-extern std::vector<Lecturer*> g_lecturers;
-extern std::vector<Room*> g_rooms;
-extern std::vector<SessionType*> g_sessionTypes;
-extern std::vector<StudentGroup*> g_studentGroups;
+// Interned text of every entity ID and name
+extern StringInterner g_strings;
+
+// Owns every module, lecturer, room, session type, student group and student
+extern EntityRegistry g_registry;
+
+// Declare external variables; all are read-only views of g_registry
+extern const std::vector<Module*>& g_modules;
+extern const std::vector<Student*>& g_students;
+extern const std::vector<Lecturer*>& g_lecturers;
+extern const std::vector<Room*>& g_rooms;
+extern const std::vector<SessionType*>& g_sessionTypes;
+extern const std::vector<StudentGroup*>& g_studentGroups;
+
+// Journal that state changes are recorded to, or nullptr while they should not be
+extern Journal* g_journal;
 
 #endif // GLOBAL_VARIABLES_H
\ No newline at end of file
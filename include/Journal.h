@@ -0,0 +1,271 @@
+
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class UserManager;
+class TimetableManager;
+
+/**
+ * @class JournalRecord
+ * @brief One state change, encoded as a type plus compact binary fields
+ *
+ * Entities are referred to by their IDs, so a record stays meaningful
+ * however the collections are ordered when it is replayed.
+ */
+class JournalRecord {
+public:
+    /**
+     * @brief Kinds of state change that are journaled
+     */
+    enum class Type : std::uint8_t {
+        CreateEntry = 1,        // entryID, week mask, moduleCode, lecturerID, roomID, groupID, typeID, day, start, end
+        DeleteEntry,            // entryID
+        CreateModule,           // code, title, description
+        UpdateModule,           // code, title, description
+        DeleteModule,           // code
+        CreateStudentGroup,     // groupID, name
+        DeleteStudentGroup,     // groupID
+        DefineSessionType,      // typeID, name
+        UpdateSessionType,      // typeID, name
+        DeleteSessionType,      // typeID
+        RegisterLecturer,       // lecturerID, name, department
+        AssignLecturerToModule, // lecturerID, moduleCode
+        DeleteLecturer,         // lecturerID
+        AddRoom,                // roomID, location, capacity
+        DeleteRoom,             // roomID
+        RegisterAdmin,          // userID, name, password, department
+        RegisterStudent,        // userID, name, password, studentNumber, course (self-registration)
+        AdminRegisterStudent,   // userID, name, password, studentNumber, course (by an admin)
+        DeleteUser,             // userID
+        AssignStudentToGroup,   // studentID, groupID
+        RemoveStudentFromGroup, // groupID, studentID
+        ChangePassword          // userID, newPassword
+    };
+
+private:
+    Type type;
+    std::string payload;
+
+public:
+    /**
+     * @brief Constructor for JournalRecord class
+     * @param recordType Kind of state change
+     */
+    explicit JournalRecord(Type recordType);
+
+    /**
+     * @brief Appends a length-prefixed string field
+     * @param value Field value
+     * @return This record, for chaining
+     */
+    JournalRecord& str(std::string_view value);
+
+    /**
+     * @brief Appends an 8-bit field
+     * @param value Field value
+     * @return This record, for chaining
+     */
+    JournalRecord& u8(std::uint8_t value);
+
+    /**
+     * @brief Appends a 16-bit field
+     * @param value Field value
+     * @return This record, for chaining
+     */
+    JournalRecord& u16(std::uint16_t value);
+
+    /**
+     * @brief Appends a 32-bit signed field
+     * @param value Field value
+     * @return This record, for chaining
+     */
+    JournalRecord& i32(std::int32_t value);
+
+    /**
+     * @brief Appends a 64-bit field
+     * @param value Field value
+     * @return This record, for chaining
+     */
+    JournalRecord& u64(std::uint64_t value);
+
+    /**
+     * @brief Gets the record type
+     * @return Kind of state change
+     */
+    Type getType() const;
+
+    /**
+     * @brief Gets the encoded fields
+     * @return Encoded fields
+     */
+    const std::string& getPayload() const;
+};
+
+/**
+ * @class Journal
+ * @brief Append-only write-ahead log of state changes since the last snapshot
+ *
+ * Every record gets a log sequence number (LSN). Appends only copy the
+ * record into a buffer; a background thread writes and fsyncs the buffer
+ * every few milliseconds, or sooner once it fills, so a burst of edits
+ * shares a single fsync. Snapshots store the LSN they include, and replay
+ * skips records the snapshot already covers.
+ *
+ * Compaction rotates the log to a ".old" segment, encodes a snapshot of
+ * the current state and writes it in the background, then removes the old
+ * segment. Until that finishes, startup replays the old segment first.
+ */
+class Journal {
+private:
+    std::string filename;
+    std::FILE* file;
+    std::uint64_t lastLSN;        // Last LSN handed out
+    std::uint64_t durableLSN;     // Last LSN written and synced
+    std::string pending;          // Encoded records not yet written
+    std::uint64_t pendingLSN;     // Last LSN in pending
+    std::uint64_t bytesWritten;   // Size of the current segment
+    std::uint64_t compactionThreshold;
+    bool writing;                 // A write of pending records is in progress
+    bool failed;                  // A write failed; appends stop until the next segment
+    bool stopping;
+
+    std::mutex mutex;
+    std::condition_variable flushWanted;
+    std::condition_variable flushed;
+    std::thread flusher;
+    std::thread compactor;
+
+    // Body of the background thread that group-commits pending records
+    void flushLoop();
+
+    // Writes and syncs pending records; called with the mutex held and releases it while writing
+    void writePending(std::unique_lock<std::mutex>& lock);
+
+    // Helper function to open a segment file and write its header
+    bool openSegment();
+
+    // Helper function to replay one segment file
+    static bool replaySegment(const std::string& segment, std::uint64_t afterLSN,
+                              UserManager& userManager, TimetableManager& timetableManager,
+                              std::uint64_t& lastLSN, size_t& applied);
+
+public:
+    /**
+     * @brief Records buffered beyond this size are written without waiting for the next commit
+     */
+    static constexpr size_t GROUP_COMMIT_BYTES = 64 * 1024;
+
+    /**
+     * @brief Longest time a record waits in the buffer before it is written and synced
+     */
+    static constexpr int GROUP_COMMIT_MILLISECONDS = 5;
+
+    /**
+     * @brief Constructor for Journal class
+     * @param journalFile Path of the journal segment
+     * @param threshold Segment size in bytes beyond which compaction is due
+     */
+    explicit Journal(const std::string& journalFile, std::uint64_t threshold = 4 * 1024 * 1024);
+
+    /**
+     * @brief Destructor, writes any pending records and waits for compaction
+     */
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+     * @brief Starts a new, empty journal segment, replacing any existing one
+     * @param startLSN Last LSN already covered by the snapshot; new records follow it
+     * @return True if the segment was created, false otherwise
+     */
+    bool open(std::uint64_t startLSN);
+
+    /**
+     * @brief Appends a record to the journal
+     * @param record Record to append
+     * @return LSN given to the record, or 0 if the journal is not open
+     */
+    std::uint64_t append(const JournalRecord& record);
+
+    /**
+     * @brief Blocks until a record has been written and synced
+     * @param lsn LSN returned by append
+     * @return True if the record is durable, false if writing it failed
+     */
+    bool waitDurable(std::uint64_t lsn);
+
+    /**
+     * @brief Writes and syncs all pending records now
+     * @return True if every record so far is durable, false otherwise
+     */
+    bool flush();
+
+    /**
+     * @brief Gets the last LSN handed out
+     * @return Last LSN
+     */
+    std::uint64_t getLastLSN();
+
+    /**
+     * @brief Checks if the current segment has grown past the compaction threshold
+     * @return True if compaction is due, false otherwise
+     */
+    bool needsCompaction();
+
+    /**
+     * @brief Compacts the journal into a new snapshot
+     *
+     * The snapshot is encoded on the calling thread, so the state must not
+     * change during the call; writing it and removing the old segment
+     * happen in the background.
+     *
+     * @param snapshotFile Snapshot file to write
+     * @param userManager Users to save
+     * @param timetableManager Timetable entries to save
+     * @return True if compaction started, false otherwise
+     */
+    bool compact(const std::string& snapshotFile, const UserManager& userManager,
+                 const TimetableManager& timetableManager);
+
+    /**
+     * @brief Waits for a background compaction to finish
+     */
+    void waitForCompaction();
+
+    /**
+     * @brief Replays a journal on top of a loaded snapshot
+     *
+     * The ".old" segment left by an interrupted compaction is replayed
+     * first. Replay stops at the first incomplete or damaged record, which
+     * is where a crash interrupted a write. A segment replay stopped in, and
+     * the main segment when the old one was stopped in, are renamed aside
+     * with a ".damaged" suffix so opening the journal afterwards cannot
+     * overwrite the records that were not replayed. Conflicts are rescanned
+     * once at the end.
+     *
+     * @param journalFile Path of the journal segment
+     * @param afterLSN LSN covered by the snapshot; older records are skipped
+     * @param userManager User manager to apply user changes to
+     * @param timetableManager Timetable manager to apply entry changes to
+     * @param lastLSN Set to the last LSN seen, at least afterLSN
+     * @param setAside If given, set to the paths segments were renamed to
+     * @return Number of records applied
+     */
+    static size_t replay(const std::string& journalFile, std::uint64_t afterLSN,
+                         UserManager& userManager, TimetableManager& timetableManager,
+                         std::uint64_t& lastLSN, std::vector<std::string>* setAside = nullptr);
+};
+
+#endif // JOURNAL_H
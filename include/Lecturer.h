@@ -4,10 +4,12 @@
 #define LECTURER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include "StringInterner.h"
 #include "Module.h"
 #include "TimeSlot.h"
+#include "OccupancyCalendar.h"
 
 /**
  * @class Lecturer
@@ -18,11 +20,11 @@
  */
 class Lecturer {
 private:
-    std::string lecturerID;
-    std::string name;
-    std::string department;
+    StringInterner::Symbol lecturerID;
+    StringInterner::Symbol name;
+    StringInterner::Symbol department;
     std::vector<Module*> assignedModules;
-    std::map<std::string, std::vector<TimeSlot*>> schedule; // Day -> List of occupied time slots
+    OccupancyCalendar schedule; // Occupied time slots per week and day
 
 public:
     /**
@@ -37,19 +39,25 @@ public:
      * @brief Gets the lecturer ID
      * @return Lecturer ID string
      */
-    std::string getLecturerID() const;
+    std::string_view getLecturerID() const;
+
+    /**
+     * @brief Gets the interned lecturer ID
+     * @return Symbol of the lecturer ID
+     */
+    StringInterner::Symbol getLecturerSymbol() const;
 
     /**
      * @brief Gets the lecturer's name
      * @return Lecturer name string
      */
-    std::string getName() const;
+    std::string_view getName() const;
 
     /**
      * @brief Gets the lecturer's department
      * @return Department string
      */
-    std::string getDepartment() const;
+    std::string_view getDepartment() const;
 
     /**
      * @brief Gets all modules assigned to the lecturer
@@ -69,22 +77,39 @@ public:
      * @param moduleCode Code of the module to remove
      * @return True if module was removed, false if not found
      */
-    bool removeModule(const std::string& moduleCode);
+    bool removeModule(std::string_view moduleCode);
 
     /**
      * @brief Checks if lecturer is available at a specific time
-     * @param day Day of the week
+     * @param week Week number (1-53)
      * @param timeSlot Time slot to check
      * @return True if lecturer is available, false if busy
      */
-    bool isAvailable(const TimeSlot& timeSlot) const;
+    bool isAvailable(int week, const TimeSlot& timeSlot) const;
+
+    /**
+     * @brief Checks a block of candidate time slots in a given week
+     * @param week Week number (1-53)
+     * @param slots Candidate time slots
+     * @param available One flag per slot; cleared for every slot the lecturer is booked in
+     * @return True if any flag is still set, false otherwise
+     */
+    bool filterAvailable(int week, const SlotBatch& slots, std::vector<std::uint8_t>& available) const;
 
     /**
      * @brief Adds a time slot to the lecturer's schedule
+     * @param week Week number (1-53)
      * @param timeSlot Time slot to add
      * @return True if time slot was added, false if conflict exists
      */
-    bool addToSchedule(TimeSlot* timeSlot);
+    bool addToSchedule(int week, const TimeSlot& timeSlot);
+
+    /**
+     * @brief Removes a time slot from the lecturer's schedule
+     * @param week Week number (1-53)
+     * @param timeSlot Time slot to remove
+     */
+    void removeFromSchedule(int week, const TimeSlot& timeSlot);
 
     /**
      * @brief Gets detailed lecturer information
@@ -0,0 +1,62 @@
+
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @class MappedFile
+ * @brief Read-only view of a whole file's contents
+ *
+ * On POSIX systems the file is memory-mapped, so large files are paged in
+ * on demand rather than copied. Elsewhere, or if mapping fails, the file is
+ * read into a buffer instead. The contents stay valid until the file is
+ * closed or the object is destroyed.
+ */
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+    bool mapped;
+    std::string buffer;
+
+    // Helper function to read the whole file into buffer
+    bool readIntoBuffer(const std::string& filename);
+
+public:
+    /**
+     * @brief Constructor for MappedFile class
+     */
+    MappedFile();
+
+    /**
+     * @brief Destructor, unmaps the file if it is open
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Opens a file, closing any file already open
+     * @param filename Path of the file to open
+     * @return True if the file was opened, false otherwise
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Closes the file
+     */
+    void close();
+
+    /**
+     * @brief Gets the file contents
+     * @return View of the whole file, empty if no file is open
+     */
+    std::string_view contents() const;
+};
+
+#endif // MAPPED_FILE_H
@@ -4,19 +4,22 @@
 #define MODULE_H
 
 #include <string>
+#include <string_view>
+#include "StringInterner.h"
 
 /**
  * @class Module
  * @brief Represents an academic module in the timetabling system
  *
  * The Module class stores information about academic modules including
- * module code, title, and description.
+ * module code, title, and description. The text is interned, so the
+ * getters return views and modules compare by symbol.
  */
 class Module {
 private:
-    std::string moduleCode;
-    std::string title;
-    std::string description;
+    StringInterner::Symbol moduleCode;
+    StringInterner::Symbol title;
+    StringInterner::Symbol description;
 
 public:
     /**
@@ -31,19 +34,25 @@ public:
      * @brief Gets the module code
      * @return Module code string
      */
-    std::string getModuleCode() const;
+    std::string_view getModuleCode() const;
+
+    /**
+     * @brief Gets the interned module code
+     * @return Symbol of the module code
+     */
+    StringInterner::Symbol getModuleSymbol() const;
 
     /**
      * @brief Gets the module title
      * @return Module title string
      */
-    std::string getTitle() const;
+    std::string_view getTitle() const;
 
     /**
      * @brief Gets the module description
      * @return Module description string
      */
-    std::string getDescription() const;
+    std::string_view getDescription() const;
 
     /**
      * @brief Gets detailed module information
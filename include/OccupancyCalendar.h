@@ -0,0 +1,150 @@
+
+
+#ifndef OCCUPANCY_CALENDAR_H
+#define OCCUPANCY_CALENDAR_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "TimeSlot.h"
+
+/**
+ * @class SlotBatch
+ * @brief A block of candidate time slots prepared for batch availability checks
+ *
+ * The bucket range and day of each slot are worked out once here and kept
+ * in parallel arrays, so checking the whole block against many weeks and
+ * calendars only repeats the overlap test itself.
+ */
+class SlotBatch {
+private:
+    std::vector<std::int64_t> firstBucket;   // First bucket the slot covers whole
+    std::vector<std::int64_t> endBucket;     // One past the last bucket it covers whole
+    std::vector<std::int64_t> firstWord;     // Index of the slot's day's first word in a week's bits
+    std::vector<std::uint8_t> valid;
+    std::vector<TimeSlot> partial;           // Slots that cover part of a bucket, checked minute by minute
+    std::vector<std::uint32_t> partialIndex; // Position of each of those slots in the block
+
+    friend class OccupancyCalendar;
+
+public:
+    /**
+     * @brief Constructor for SlotBatch class
+     * @param slots Candidate time slots; invalid slots are never free
+     */
+    explicit SlotBatch(const std::vector<TimeSlot>& slots);
+
+    /**
+     * @brief Gets the number of candidate slots
+     * @return Number of slots
+     */
+    size_t size() const;
+};
+
+/**
+ * @class OccupancyCalendar
+ * @brief Tracks when a resource is booked across the weeks of the year
+ *
+ * Each (week, day) is a bitset of 5-minute buckets, so checking, booking and
+ * releasing a slot are a handful of word-wide AND, OR and AND-NOT operations.
+ * A bucket's bit is set once any of its minutes is booked. The few buckets
+ * booked only in part, where a session starts or ends off the 5-minute
+ * grid, also keep which of their minutes are booked, so sessions meeting
+ * inside a bucket (09:00-09:52 and 09:52-10:40) do not clash. A week's
+ * bitsets are only allocated once something is booked in it, so a calendar
+ * never uses more than 53 x 7 x 288 bits plus its partly booked buckets.
+ * Blocks of candidate slots are checked together by filterFree, four at a
+ * time with AVX2 where the processor supports it.
+ */
+class OccupancyCalendar {
+public:
+    static constexpr int WEEKS = 53;
+    static constexpr int DAYS = 7;
+    static constexpr int BUCKET_MINUTES = 5;
+    static constexpr int BUCKETS_PER_DAY = TimeSlot::MINUTES_PER_DAY / BUCKET_MINUTES;
+    static constexpr int WORDS_PER_DAY = (BUCKETS_PER_DAY + 63) / 64;
+
+    using DayBits = std::array<std::uint64_t, WORDS_PER_DAY>;
+
+private:
+    // Minutes of a bucket, one bit each
+    static constexpr std::uint8_t ALL_MINUTES = (1 << BUCKET_MINUTES) - 1;
+
+    struct WeekBits {
+        std::array<DayBits, DAYS> days;
+        // Booked minutes of the buckets booked only in part, by day * BUCKETS_PER_DAY + bucket
+        std::vector<std::pair<std::uint16_t, std::uint8_t>> partial;
+    };
+
+    std::array<std::unique_ptr<WeekBits>, WEEKS> weeks;
+
+    // Builds the mask of buckets a time slot covers whole
+    static DayBits maskFor(const TimeSlot& timeSlot);
+
+    // Gets the booked minutes of one bucket of a week
+    static std::uint8_t bookedMinutes(const WeekBits& week, int day, int bucket);
+
+    // Sets the booked minutes of one bucket of a week
+    static void setBookedMinutes(WeekBits& week, int day, int bucket, std::uint8_t minutes);
+
+    // Checks the buckets a time slot covers only in part against a week's bookings
+    static bool edgesFree(const WeekBits& week, const TimeSlot& timeSlot);
+
+public:
+    /**
+     * @brief Constructor for OccupancyCalendar class
+     */
+    OccupancyCalendar();
+
+    /**
+     * @brief Checks if a time slot is free in a given week
+     * @param week Week number (1-53)
+     * @param timeSlot Time slot to check
+     * @return True if no booked bucket overlaps the slot, false otherwise
+     */
+    bool isFree(int week, const TimeSlot& timeSlot) const;
+
+    /**
+     * @brief Checks a block of candidate slots in a given week
+     *
+     * Flags are only ever cleared, so calling this for several weeks or
+     * calendars with the same flags leaves set exactly the slots free in all
+     * of them.
+     *
+     * @param week Week number (1-53)
+     * @param slots Candidate slots
+     * @param free One flag per slot; cleared for every slot that is not free
+     * @return True if any flag is still set, false otherwise
+     */
+    bool filterFree(int week, const SlotBatch& slots, std::vector<std::uint8_t>& free) const;
+
+    /**
+     * @brief Books a time slot in a given week
+     * @param week Week number (1-53)
+     * @param timeSlot Time slot to book
+     * @return True if booking successful, false if invalid or already booked
+     */
+    bool book(int week, const TimeSlot& timeSlot);
+
+    /**
+     * @brief Marks a time slot as busy even if part of it is already booked
+     *
+     * Unlike book, marked slots may overlap, so they cannot be released
+     * exactly afterwards. Use it for read-only views of existing bookings.
+     *
+     * @param week Week number (1-53)
+     * @param timeSlot Time slot to mark
+     */
+    void markBusy(int week, const TimeSlot& timeSlot);
+
+    /**
+     * @brief Releases a previously booked time slot
+     * @param week Week number (1-53)
+     * @param timeSlot Time slot to release
+     */
+    void release(int week, const TimeSlot& timeSlot);
+};
+
+#endif // OCCUPANCY_CALENDAR_H
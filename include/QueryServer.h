@@ -0,0 +1,82 @@
+
+
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "ThreadPool.h"
+#include "TimetableManager.h"
+
+/**
+ * @class QueryServer
+ * @brief Answers timetable queries over HTTP on the loopback interface
+ *
+ * Each GET request is answered with a JSON list of entries:
+ *   /group/{groupID}, /lecturer/{lecturerID} and /room/{roomID} return that
+ *   timetable, and /search returns the entries matching its module, room and
+ *   lecturer parameters. Every route takes an optional week parameter.
+ * One thread accepts connections and hands each to a worker pool, which
+ * reads the request, answers it and closes the connection. Each request is
+ * answered from the manager's latest published version, so requests never
+ * wait for changes to the timetable or for each other.
+ */
+class QueryServer {
+private:
+    const TimetableManager& timetableManager;
+    ThreadPool workers;
+    int listenSocket;                       // -1 until listen succeeds
+    std::atomic<bool> stopping;
+    std::atomic<size_t> requestsServed;
+
+    // Helper function to read one request from a connection, answer it and close the connection
+    void handleConnection(int socket);
+
+    // Helper function to build the response body for a request, setting the HTTP status code
+    std::string answer(std::string_view method, std::string_view target, int& status) const;
+
+public:
+    /**
+     * @brief Constructor for QueryServer class
+     * @param timetable Timetable manager the queries are answered from
+     * @param threadCount Number of worker threads answering requests
+     */
+    QueryServer(const TimetableManager& timetable, size_t threadCount);
+
+    /**
+     * @brief Destructor, closes the listening socket
+     */
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * @brief Starts listening for connections on 127.0.0.1
+     * @param port TCP port to listen on
+     * @return True if the socket was bound, false otherwise
+     */
+    bool listen(unsigned short port);
+
+    /**
+     * @brief Accepts and answers connections until stop is called
+     *
+     * Requests already handed to a worker are answered before it returns.
+     */
+    void serve();
+
+    /**
+     * @brief Asks serve to return; safe to call from a signal handler
+     */
+    void stop();
+
+    /**
+     * @brief Gets the number of requests answered so far
+     * @return Number of requests answered
+     */
+    size_t getRequestsServed() const;
+};
+
+#endif // QUERY_SERVER_H
@@ -4,9 +4,11 @@
 #define ROOM_H
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
+#include "StringInterner.h"
 #include "TimeSlot.h"
+#include "OccupancyCalendar.h"
 
 /**
  * @class Room
@@ -17,10 +19,10 @@
  */
 class Room {
 private:
-    std::string roomID;
-    std::string location;
+    StringInterner::Symbol roomID;
+    StringInterner::Symbol location;
     int capacity;
-    std::map<std::string, std::vector<TimeSlot*>> schedule; // Day -> List of occupied time slots
+    OccupancyCalendar schedule; // Occupied time slots per week and day
 
 public:
     /**
@@ -35,13 +37,19 @@ public:
      * @brief Gets the room ID
      * @return Room ID string
      */
-    std::string getRoomID() const;
+    std::string_view getRoomID() const;
+
+    /**
+     * @brief Gets the interned room ID
+     * @return Symbol of the room ID
+     */
+    StringInterner::Symbol getRoomSymbol() const;
 
     /**
      * @brief Gets the room location
      * @return Location string
      */
-    std::string getLocation() const;
+    std::string_view getLocation() const;
 
     /**
      * @brief Gets the room capacity
@@ -57,17 +65,35 @@ public:
 
     /**
      * @brief Checks if room is available at a specific time
+     * @param week Week number (1-53)
      * @param timeSlot Time slot to check
      * @return True if room is available, false if booked
      */
-    bool isAvailable(const TimeSlot& timeSlot) const;
+    bool isAvailable(int week, const TimeSlot& timeSlot) const;
+
+    /**
+     * @brief Checks a block of candidate time slots in a given week
+     * @param week Week number (1-53)
+     * @param slots Candidate time slots
+     * @param available One flag per slot; cleared for every slot the room is booked in
+     * @return True if any flag is still set, false otherwise
+     */
+    bool filterAvailable(int week, const SlotBatch& slots, std::vector<std::uint8_t>& available) const;
 
     /**
      * @brief Books a time slot for the room
+     * @param week Week number (1-53)
      * @param timeSlot Time slot to book
      * @return True if booking successful, false if conflict exists
      */
-    bool bookTimeSlot(TimeSlot* timeSlot);
+    bool bookTimeSlot(int week, const TimeSlot& timeSlot);
+
+    /**
+     * @brief Releases a booked time slot
+     * @param week Week number (1-53)
+     * @param timeSlot Time slot to release
+     */
+    void releaseTimeSlot(int week, const TimeSlot& timeSlot);
 };
 
 #endif // ROOM_H
@@ -4,6 +4,8 @@
 #define SESSION_TYPE_H
 
 #include <string>
+#include <string_view>
+#include "StringInterner.h"
 
 /**
  * @class SessionType
@@ -14,8 +16,8 @@
  */
 class SessionType {
 private:
-    std::string typeID;
-    std::string typeName;
+    StringInterner::Symbol typeID;
+    StringInterner::Symbol typeName;
 
 public:
     /**
@@ -29,13 +31,19 @@ public:
      * @brief Gets the type ID
      * @return Type ID string
      */
-    std::string getTypeID() const;
+    std::string_view getTypeID() const;
+
+    /**
+     * @brief Gets the interned type ID
+     * @return Symbol of the type ID
+     */
+    StringInterner::Symbol getTypeSymbol() const;
 
     /**
      * @brief Gets the type name
      * @return Type name string
      */
-    std::string getTypeName() const;
+    std::string_view getTypeName() const;
 
     /**
      * @brief Gets detailed session type information
@@ -0,0 +1,121 @@
+
+
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SlabPool
+ * @brief Allocates objects of one type from large contiguous slabs
+ *
+ * Objects are constructed in place in fixed-size slabs instead of each
+ * getting its own heap block, so objects created together sit next to
+ * each other in memory. Slots freed by destroy are reused by the next
+ * create. Slabs never move, so a pointer to an object stays valid until
+ * the object is destroyed, and clear releases everything slab by slab.
+ */
+template <typename T, size_t SLAB_SIZE = 256>
+class SlabPool {
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];  // First member, so an object's address is its slot's
+        Slot* nextFree;
+        bool live;
+    };
+
+    std::vector<Slot*> slabs;   // Each an array of SLAB_SIZE slots
+    size_t usedInLastSlab;      // Slots of the last slab handed out so far
+    Slot* freeList;             // Destroyed slots, most recent first
+    size_t count;
+
+    // Helper function to find a slot for a new object
+    Slot* takeSlot() {
+        if (freeList) {
+            Slot* slot = freeList;
+            freeList = slot->nextFree;
+            return slot;
+        }
+        if (slabs.empty() || usedInLastSlab == SLAB_SIZE) {
+            slabs.push_back(new Slot[SLAB_SIZE]());
+            usedInLastSlab = 0;
+        }
+        return &slabs.back()[usedInLastSlab++];
+    }
+
+public:
+    /**
+     * @brief Constructor for SlabPool class
+     */
+    SlabPool() : usedInLastSlab(0), freeList(nullptr), count(0) {
+    }
+
+    /**
+     * @brief Destructor, destroys every live object and frees the slabs
+     */
+    ~SlabPool() {
+        clear();
+    }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    /**
+     * @brief Constructs an object in the pool
+     * @param args Constructor arguments
+     * @return Pointer to the new object, valid until it is destroyed
+     */
+    template <typename... Args>
+    T* create(Args&&... args) {
+        Slot* slot = takeSlot();
+        T* object = ::new (slot->storage) T(std::forward<Args>(args)...);
+        slot->live = true;
+        ++count;
+        return object;
+    }
+
+    /**
+     * @brief Destroys an object created by this pool and keeps its slot for reuse
+     * @param object Object to destroy
+     */
+    void destroy(T* object) {
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        object->~T();
+        slot->live = false;
+        slot->nextFree = freeList;
+        freeList = slot;
+        --count;
+    }
+
+    /**
+     * @brief Destroys every live object and frees all slabs
+     */
+    void clear() {
+        for (size_t s = 0; s < slabs.size(); ++s) {
+            size_t used = s + 1 == slabs.size() ? usedInLastSlab : SLAB_SIZE;
+            for (size_t i = 0; i < used; ++i) {
+                if (slabs[s][i].live) {
+                    std::launder(reinterpret_cast<T*>(slabs[s][i].storage))->~T();
+                }
+            }
+            delete[] slabs[s];
+        }
+        slabs.clear();
+        usedInLastSlab = 0;
+        freeList = nullptr;
+        count = 0;
+    }
+
+    /**
+     * @brief Gets the number of live objects
+     * @return Number of objects
+     */
+    size_t size() const {
+        return count;
+    }
+};
+
+#endif // SLAB_POOL_H
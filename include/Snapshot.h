@@ -0,0 +1,88 @@
+
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include "UserManager.h"
+#include "TimetableManager.h"
+
+/**
+ * @class Snapshot
+ * @brief Saves and restores the whole system state in a binary file
+ *
+ * A snapshot holds every module, session type, room, lecturer, student,
+ * admin, student group and timetable entry. References between them are
+ * stored as indices into the saved tables rather than pointers. The file
+ * starts with a magic number, format version, byte order tag, payload size,
+ * checksum and the last journal LSN the snapshot includes, so damaged files
+ * and files from another machine or of another version are rejected.
+ * Loading reads the file through a memory mapping and does not touch the
+ * system until the whole file has been decoded and every entry checked,
+ * so a file is either restored in full or not at all.
+ */
+class Snapshot {
+public:
+    /**
+     * @brief Current snapshot format version
+     */
+    static constexpr unsigned int VERSION = 1;
+
+    /**
+     * @brief Outcome of load
+     */
+    enum class LoadResult {
+        Loaded,     // The state was restored
+        Missing,    // There is no snapshot file
+        Invalid,    // The file exists but cannot be read, is damaged, or is of another version or machine
+        NotEmpty    // The system already holds state, so nothing was read
+    };
+
+    /**
+     * @brief Encodes the system state as a complete snapshot file image
+     * @param userManager Users to save
+     * @param timetableManager Timetable entries to save
+     * @param lsn Last journal LSN included in the state
+     * @param image Set to the encoded file contents
+     * @return True if the state was encoded, false if an entry refers to an unlisted entity
+     */
+    static bool encode(const UserManager& userManager, const TimetableManager& timetableManager,
+                       std::uint64_t lsn, std::string& image);
+
+    /**
+     * @brief Writes an encoded snapshot and syncs it to disk
+     *
+     * The image is written to a temporary file that then replaces the
+     * target, so an interrupted write leaves the previous snapshot intact.
+     *
+     * @param filename Snapshot file to write
+     * @param image Encoded file contents
+     * @return True if the snapshot was written, false otherwise
+     */
+    static bool write(const std::string& filename, const std::string& image);
+
+    /**
+     * @brief Saves the system state
+     * @param filename Snapshot file to write
+     * @param userManager Users to save
+     * @param timetableManager Timetable entries to save
+     * @param lsn Last journal LSN included in the state
+     * @return True if the snapshot was written, false otherwise
+     */
+    static bool save(const std::string& filename, const UserManager& userManager,
+                     const TimetableManager& timetableManager, std::uint64_t lsn = 0);
+
+    /**
+     * @brief Loads the system state into an empty system
+     * @param filename Snapshot file to read
+     * @param userManager User manager to restore users into, must have no users
+     * @param timetableManager Timetable manager to restore entries into, must have no entries
+     * @param lsn If given, set to the last journal LSN included in the snapshot
+     * @return Loaded if the state was restored; otherwise why not, with the system left untouched
+     */
+    static LoadResult load(const std::string& filename, UserManager& userManager,
+                     TimetableManager& timetableManager, std::uint64_t* lsn = nullptr);
+};
+
+#endif // SNAPSHOT_H
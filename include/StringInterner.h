@@ -0,0 +1,123 @@
+
+
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class StringInterner
+ * @brief Gives every distinct string a 32-bit symbol
+ *
+ * Each text is stored once and never freed, so a symbol and the view it
+ * maps back to stay valid for the life of the interner. Two strings are
+ * equal exactly when their symbols are, which turns ID comparisons into
+ * integer compares and lets symbols key plain integer maps. Texts live in
+ * segments that double in size and never move, and the lookup table is
+ * open addressing over symbols, probed by the stored hash before any text
+ * is compared.
+ *
+ * find, view and size never lock and may run on any thread while another
+ * thread interns. A new symbol is written before it is stored in the
+ * table, and a grown table is built aside and then swapped in, so a
+ * reader sees either a complete symbol or none. Interning takes a lock
+ * only to add a string that is not there yet.
+ */
+class StringInterner {
+public:
+    /**
+     * @brief Handle of an interned string
+     */
+    using Symbol = std::uint32_t;
+
+    /**
+     * @brief Symbol returned by find for a string that was never interned
+     */
+    static constexpr Symbol NONE = 0xFFFFFFFF;
+
+private:
+    struct Record {
+        size_t hash;
+        std::string text;
+    };
+
+    // Symbols by hash slot, NONE where empty; size is a power of two
+    struct Table {
+        std::vector<std::atomic<Symbol>> slots;
+        explicit Table(size_t capacity);
+    };
+
+    // Segment k holds the records of 2^(FIRST_SEGMENT_BITS + k) symbols
+    static constexpr int FIRST_SEGMENT_BITS = 6;
+    static constexpr int SEGMENT_COUNT = 32;
+
+    std::atomic<Record*> segments[SEGMENT_COUNT] = {};
+    std::atomic<Table*> table;                   // Table readers probe
+    std::vector<std::unique_ptr<Table>> tables;  // Every table made; a reader may still be probing an old one
+    std::atomic<size_t> count;
+    std::mutex internMutex;                      // Held while adding a symbol
+
+    static size_t hashOf(std::string_view text);
+
+    // Helper function to find the segment of a symbol and its offset in it
+    static int segmentOf(Symbol symbol, size_t& offset);
+
+    // Helper function to get the record of a symbol that has been handed out
+    const Record& record(Symbol symbol) const;
+
+    // Helper function to find the symbol of a text in a table, setting slot to where it is or would go
+    Symbol lookup(const Table& in, std::string_view text, size_t hash, size_t& slot) const;
+
+    // Helper function to swap in a table of twice the size holding every symbol
+    void grow();
+
+public:
+    /**
+     * @brief Constructor for StringInterner class
+     */
+    StringInterner();
+
+    /**
+     * @brief Destructor for StringInterner class
+     */
+    ~StringInterner();
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    /**
+     * @brief Gets the symbol of a string, interning it if it is new
+     * @param text String to intern
+     * @return Symbol of the string
+     */
+    Symbol intern(std::string_view text);
+
+    /**
+     * @brief Looks up the symbol of a string without interning it
+     * @param text String to look up
+     * @return Symbol of the string, or NONE if it was never interned
+     */
+    Symbol find(std::string_view text) const;
+
+    /**
+     * @brief Gets the text of a symbol
+     * @param symbol Symbol returned by intern
+     * @return View of the interned text, valid for the life of the interner
+     */
+    std::string_view view(Symbol symbol) const;
+
+    /**
+     * @brief Gets the number of distinct strings interned
+     * @return Number of symbols handed out
+     */
+    size_t size() const;
+};
+
+#endif // STRING_INTERNER_H
@@ -10,6 +10,7 @@
 // Forward declarations
 class TimetableManager;
 class TimetableEntry;
+class StudentGroup;
 
 /**
  * @class Student
@@ -19,8 +20,14 @@ class TimetableEntry;
  */
 class Student : public User {
 private:
-    std::string studentNumber;
-    std::string course;
+    StringInterner::Symbol studentNumber;
+    StringInterner::Symbol course;
+    std::vector<StudentGroup*> groups; // Groups this student belongs to, maintained by StudentGroup
+
+    // Membership bookkeeping, called by StudentGroup when the student is added or removed
+    friend class StudentGroup;
+    void joinGroup(StudentGroup* group);
+    void leaveGroup(StudentGroup* group);
 
 public:
     /**
@@ -34,6 +41,11 @@ public:
     Student(const std::string& id, const std::string& name, const std::string& pwd,
             const std::string& studentNum, const std::string& courseName);
 
+    /**
+     * @brief Destructor that removes the student from all of its groups
+     */
+    ~Student() override;
+
     /**
      * @brief Gets student details including student number and course
      * @return String containing student information
@@ -44,13 +56,19 @@ public:
      * @brief Gets the student number
      * @return Student number string
      */
-    std::string getStudentNumber() const;
+    std::string_view getStudentNumber() const;
 
     /**
      * @brief Gets the student's course
      * @return Course string
      */
-    std::string getCourse() const;
+    std::string_view getCourse() const;
+
+    /**
+     * @brief Gets the groups the student belongs to
+     * @return Vector of pointers to student groups
+     */
+    const std::vector<StudentGroup*>& getGroups() const;
 
     /**
      * @brief Views the student's timetable for a specific week
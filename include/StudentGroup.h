@@ -4,7 +4,9 @@
 #define STUDENT_GROUP_H
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include "StringInterner.h"
 #include "Student.h"
 
 /**
@@ -16,8 +18,8 @@
  */
 class StudentGroup {
 private:
-    std::string groupID;
-    std::string groupName;
+    StringInterner::Symbol groupID;
+    StringInterner::Symbol groupName;
     std::vector<Student*> students;
 
 public:
@@ -28,17 +30,28 @@ public:
      */
     StudentGroup(const std::string& id, const std::string& name);
 
+    /**
+     * @brief Destructor that removes the group from its students' memberships
+     */
+    ~StudentGroup();
+
     /**
      * @brief Gets the group ID
      * @return Group ID string
      */
-    std::string getGroupID() const;
+    std::string_view getGroupID() const;
+
+    /**
+     * @brief Gets the interned group ID
+     * @return Symbol of the group ID
+     */
+    StringInterner::Symbol getGroupSymbol() const;
 
     /**
      * @brief Gets the group name
      * @return Group name string
      */
-    std::string getGroupName() const;
+    std::string_view getGroupName() const;
 
     /**
      * @brief Gets all students in the group
@@ -58,14 +71,14 @@ public:
      * @param studentID ID of the student to remove
      * @return True if student was removed, false if not found
      */
-    bool removeStudent(const std::string& studentID);
+    bool removeStudent(std::string_view studentID);
 
     /**
      * @brief Checks if a student is in the group
      * @param studentID ID of the student to check
      * @return True if student is in the group, false otherwise
      */
-    bool hasStudent(const std::string& studentID) const;
+    bool hasStudent(std::string_view studentID) const;
 
     /**
      * @brief Gets detailed group information
@@ -0,0 +1,81 @@
+
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads that run submitted tasks
+ *
+ * Tasks run in no particular order. Callers that need a deterministic
+ * result give each task its own output slot and combine the slots after
+ * wait() returns.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable allDone;
+    size_t running;
+    bool stopping;
+
+    // Body of each worker thread
+    void workerLoop();
+
+public:
+    /**
+     * @brief Constructor for ThreadPool class
+     * @param threadCount Number of worker threads, at least one is started
+     */
+    explicit ThreadPool(size_t threadCount);
+
+    /**
+     * @brief Destructor, finishes queued tasks and joins the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queues a task to run on a worker thread
+     * @param task Task to run
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Blocks until every submitted task has finished
+     */
+    void wait();
+
+    /**
+     * @brief Runs a numbered task for every number below a count and waits for all of them
+     *
+     * Each worker claims the next unclaimed number whenever it finishes a
+     * task, so workers that drew short tasks take over the remaining ones
+     * instead of waiting on a worker stuck with a long one. Numbering the
+     * largest tasks first keeps the last tasks short.
+     *
+     * @param count Number of tasks
+     * @param task Task to run, called with each number from 0 to count - 1 exactly once
+     */
+    void forEach(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * @brief Gets the number of worker threads
+     * @return Number of workers
+     */
+    size_t size() const;
+};
+
+#endif // THREAD_POOL_H
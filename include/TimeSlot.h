@@ -4,38 +4,90 @@
 #define TIMESLOT_H
 
 #include <string>
+#include <string_view>
+#include <cstdint>
 
 /**
  * @class TimeSlot
  * @brief Represents a time slot in the timetabling system
  *
  * The TimeSlot class defines time periods for scheduling sessions,
- * including day, start time, and end time.
+ * including day, start time, and end time. The day and times are parsed
+ * once at construction into a packed minute-of-week interval, so overlap
+ * checks are plain integer comparisons.
  */
 class TimeSlot {
+public:
+    /**
+     * @brief Days of the week, in calendar order
+     */
+    enum class Day : std::uint8_t {
+        Monday, Tuesday, Wednesday, Thursday, Friday, Saturday, Sunday, Invalid
+    };
+
+    /**
+     * @brief Number of minutes in a day
+     */
+    static constexpr int MINUTES_PER_DAY = 24 * 60;
+
 private:
-    std::string day;
-    std::string startTime;
-    std::string endTime;
+    Day day;
+    std::uint16_t start; // Minutes since Monday 00:00
+    std::uint16_t end;   // Minutes since Monday 00:00
 
-    // Helper function to convert time string to minutes since midnight
-    int timeToMinutes(const std::string& timeStr) const;
+    // Helper function to format minutes since midnight as "HH:MM"
+    static std::string minutesToTime(int minutes);
 
 public:
     /**
      * @brief Constructor for TimeSlot class
-     * @param d Day of the week
+     * @param d Day of the week (e.g. "Monday" or "Mon", case-insensitive)
      * @param start Start time (format: "HH:MM")
      * @param end End time (format: "HH:MM")
      */
     TimeSlot(const std::string& d, const std::string& start, const std::string& end);
 
+    /**
+     * @brief Constructor for TimeSlot class from already parsed values
+     * @param d Day of the week
+     * @param startMinutes Start time in minutes since midnight
+     * @param endMinutes End time in minutes since midnight
+     */
+    TimeSlot(Day d, int startMinutes, int endMinutes);
+
+    /**
+     * @brief Parses a day name
+     * @param name Day name (e.g. "Monday" or "Mon", case-insensitive)
+     * @return Parsed day, or Day::Invalid if the name is not recognised
+     */
+    static Day parseDay(std::string_view name);
+
+    /**
+     * @brief Parses a time of day
+     * @param timeStr Time string (format: "HH:MM" or "H:MM", up to "24:00")
+     * @return Minutes since midnight, or -1 if the time is malformed
+     */
+    static int timeToMinutes(std::string_view timeStr);
+
+    /**
+     * @brief Gets the display name of a day
+     * @param d Day of the week
+     * @return Day name string
+     */
+    static std::string dayName(Day d);
+
     /**
      * @brief Gets the day
      * @return Day string
      */
     std::string getDay() const;
 
+    /**
+     * @brief Gets the day as an enumeration value
+     * @return Day of the week
+     */
+    Day getDayOfWeek() const;
+
     /**
      * @brief Gets the start time
      * @return Start time string
@@ -48,6 +100,24 @@ public:
      */
     std::string getEndTime() const;
 
+    /**
+     * @brief Gets the start time as minutes since midnight
+     * @return Start time in minutes
+     */
+    int getStartMinutes() const;
+
+    /**
+     * @brief Gets the end time as minutes since midnight
+     * @return End time in minutes
+     */
+    int getEndMinutes() const;
+
+    /**
+     * @brief Checks if the day and times were parsed and the slot ends after it starts
+     * @return True if the time slot is valid, false otherwise
+     */
+    bool isValid() const;
+
     /**
      * @brief Gets detailed time slot information
      * @return String containing time slot details
@@ -2,13 +2,16 @@
 #ifndef TIMETABLE_ENTRY_H
 #define TIMETABLE_ENTRY_H
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include "Module.h"
 #include "Lecturer.h"
 #include "Room.h"
 #include "StudentGroup.h"
 #include "SessionType.h"
 #include "TimeSlot.h"
+#include "WeekSet.h"
 
 /**
  * @class TimetableEntry
@@ -16,50 +19,51 @@
  *
  * The TimetableEntry class combines all necessary components to define
  * a scheduled session: module, lecturer, room, student group, session type,
- * and time slot.
+ * and time slot. The time slot is held by value, so an entry and its slot
+ * are one allocation. An entry that repeats at the same time and place in
+ * several weeks is stored once with the set of weeks it runs in.
  */
 class TimetableEntry {
 private:
     std::string entryID;
-    int weekNumber;
+    WeekSet weeks;
     Module* module;
     Lecturer* lecturer;
     Room* room;
     StudentGroup* studentGroup;
     SessionType* sessionType;
-    TimeSlot* timeSlot;
+    TimeSlot timeSlot;
+    size_t row;         // Row in the columns that last appended or moved the entry
+
+    // The columns keep row current, so finding an entry's row takes no search
+    friend class EntryColumns;
 
 public:
     /**
      * @brief Constructor for TimetableEntry class
      * @param id Unique entry identifier
-     * @param week Week number (1-53)
+     * @param runWeeks Weeks the session runs in
      * @param mod Pointer to module
      * @param lec Pointer to lecturer
      * @param rm Pointer to room
      * @param group Pointer to student group
      * @param session Pointer to session type
-     * @param time Pointer to time slot
-     */
-    TimetableEntry(const std::string& id, int week, Module* mod, Lecturer* lec,
-                  Room* rm, StudentGroup* group, SessionType* session, TimeSlot* time);
-
-    /**
-     * @brief Destructor to clean up owned time slot
+     * @param time Time slot
      */
-    ~TimetableEntry();
+    TimetableEntry(const std::string& id, const WeekSet& runWeeks, Module* mod, Lecturer* lec,
+                  Room* rm, StudentGroup* group, SessionType* session, const TimeSlot& time);
 
     /**
      * @brief Gets the entry ID
      * @return Entry ID string
      */
-    std::string getEntryID() const;
+    std::string_view getEntryID() const;
 
     /**
-     * @brief Gets the week number
-     * @return Week number as integer
+     * @brief Gets the weeks the session runs in
+     * @return Set of week numbers
      */
-    int getWeekNumber() const;
+    const WeekSet& getWeeks() const;
 
     /**
      * @brief Gets the module
@@ -95,7 +99,7 @@ public:
      * @brief Gets the time slot
      * @return Pointer to time slot
      */
-    TimeSlot* getTimeSlot() const;
+    const TimeSlot* getTimeSlot() const;
 
     /**
      * @brief Gets detailed entry information
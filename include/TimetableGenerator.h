@@ -0,0 +1,118 @@
+
+
+#ifndef TIMETABLE_GENERATOR_H
+#define TIMETABLE_GENERATOR_H
+
+#include <vector>
+#include <string>
+#include "TimetableManager.h"
+
+/**
+ * @struct SessionDemand
+ * @brief Teaching that has to be scheduled for a module
+ *
+ * A demand asks for sessionsPerWeek sessions of durationMinutes each, so its
+ * weekly hours are sessionsPerWeek * durationMinutes / 60. Every session is
+ * held at the same day, time and room in each week from firstWeek to lastWeek.
+ */
+struct SessionDemand {
+    Module* module;
+    SessionType* sessionType;
+    Lecturer* lecturer;
+    StudentGroup* studentGroup;
+    int sessionsPerWeek;
+    int durationMinutes;
+    int capacityNeeded;
+    int firstWeek;
+    int lastWeek;
+};
+
+/**
+ * @struct GenerationOptions
+ * @brief Settings for automatic timetable generation
+ */
+struct GenerationOptions {
+    std::vector<TimeSlot::Day> days = {TimeSlot::Day::Monday, TimeSlot::Day::Tuesday,
+                                       TimeSlot::Day::Wednesday, TimeSlot::Day::Thursday,
+                                       TimeSlot::Day::Friday};
+    int dayStartMinutes = 9 * 60;       // Earliest session start
+    int dayEndMinutes = 18 * 60;        // Latest session end
+    int startStepMinutes = 30;          // Sessions start on multiples of this after dayStartMinutes
+    int improvementIterations = 20000;  // Local search moves tried after construction, over all threads
+    unsigned int seed = 1;              // Seed for the local search
+    unsigned int threads = 1;           // Searches run in parallel, each from its own seed
+    int shareEpochs = 8;                // Times parallel searches stop to adopt the best solution so far
+};
+
+/**
+ * @struct GenerationStats
+ * @brief Outcome and timings of a generation run
+ */
+struct GenerationStats {
+    size_t sessionsRequested = 0;
+    size_t sessionsPlaced = 0;
+    size_t entriesCreated = 0;          // One per placed session, covering all its weeks
+    long long softCost = 0;             // Room waste, off-peak time and same-day repeats
+    double constructionSeconds = 0.0;
+    double improvementSeconds = 0.0;
+    double totalSeconds = 0.0;
+    double placementsPerSecond = 0.0;   // Sessions placed per second of construction, over all threads
+    size_t threadsUsed = 0;
+    long long movesTried = 0;
+    double movesPerSecond = 0.0;        // Local search moves per second of improvement
+};
+
+/**
+ * @class TimetableGenerator
+ * @brief Builds a conflict-free timetable from per-module session demands
+ *
+ * Sessions are first placed greedily, hardest first, each at the cheapest
+ * feasible day, time and smallest large-enough room. A local search then
+ * relocates sessions to lower the soft cost and ejects single blocking
+ * sessions to make room for unplaced ones. Existing room and lecturer
+ * bookings and existing student group entries are respected, and the result
+ * is committed to the timetable manager as one recurring entry per session.
+ *
+ * With more than one thread, a portfolio of searches with different seeds
+ * runs on a thread pool. They synchronise at fixed points in the move
+ * budget and continue from the best solution found so far, so a given seed
+ * and thread count always produce the same timetable.
+ */
+class TimetableGenerator {
+private:
+    TimetableManager& timetableManager;
+    std::vector<Room*> rooms;
+    std::vector<SessionDemand> demands;
+    GenerationOptions options;
+
+public:
+    /**
+     * @brief Constructor for TimetableGenerator class
+     * @param manager Timetable manager the generated entries are added to
+     * @param availableRooms Rooms sessions may be placed in
+     * @param opts Generation settings
+     */
+    TimetableGenerator(TimetableManager& manager, const std::vector<Room*>& availableRooms,
+                       const GenerationOptions& opts = GenerationOptions());
+
+    /**
+     * @brief Adds a session demand to be scheduled
+     * @param demand Demand to add
+     * @return True if the demand is valid and was added, false otherwise
+     */
+    bool addDemand(const SessionDemand& demand);
+
+    /**
+     * @brief Gets the demands added so far
+     * @return Vector of session demands
+     */
+    const std::vector<SessionDemand>& getDemands() const;
+
+    /**
+     * @brief Generates the timetable and adds its entries to the manager
+     * @return Statistics describing the run
+     */
+    GenerationStats generate();
+};
+
+#endif // TIMETABLE_GENERATOR_H
@@ -5,15 +5,67 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <span>
+#include <unordered_map>
 #include "TimetableEntry.h"
+#include "TimetableVersion.h"
 #include "ConflictDetector.h"
+#include "SlabPool.h"
 #include "Module.h"
 #include "Lecturer.h"
 #include "Room.h"
 #include "StudentGroup.h"
 #include "SessionType.h"
 #include "TimeSlot.h"
+#include "WeekSet.h"
+
+/**
+ * @struct ImportSummary
+ * @brief Outcome of a CSV import
+ */
+struct ImportSummary {
+    size_t rowsRead = 0;
+    size_t entriesImported = 0;     // Rows of the same entry in different weeks count once
+    size_t rowsSkipped = 0;     // Malformed rows, unknown references, duplicate IDs or double bookings
+};
+
+/**
+ * @struct SlotQuery
+ * @brief A session to find room and time options for with findFreeSlots
+ *
+ * The session is held at the same day, time and room in every week from
+ * firstWeek to lastWeek. A null lecturer or student group is not checked.
+ */
+struct SlotQuery {
+    Lecturer* lecturer = nullptr;
+    StudentGroup* group = nullptr;
+    int minCapacity = 0;
+    int durationMinutes = 60;
+    int firstWeek = 1;
+    int lastWeek = 1;
+    std::vector<TimeSlot::Day> days = {TimeSlot::Day::Monday, TimeSlot::Day::Tuesday,
+                                       TimeSlot::Day::Wednesday, TimeSlot::Day::Thursday,
+                                       TimeSlot::Day::Friday};
+    int dayStartMinutes = 9 * 60;       // Earliest start
+    int dayEndMinutes = 18 * 60;        // Latest end
+    int startStepMinutes = 30;          // Options start on multiples of this after dayStartMinutes
+    size_t limit = 10;                  // Most options returned
+};
+
+/**
+ * @struct SlotOption
+ * @brief A room and time the queried session fits in
+ */
+struct SlotOption {
+    Room* room;
+    TimeSlot timeSlot;
+    long long score;            // Empty seats plus minutes outside 10:00-17:00; lower is better
+};
 
 /**
  * @class TimetableManager
@@ -21,19 +73,106 @@
  *
  * The TimetableManager class is responsible for creating, storing, and
  * retrieving timetable entries, as well as checking for conflicts and
- * exporting timetable data.
+ * exporting timetable data. Entries and their indices are kept in a working
+ * TimetableVersion. Entries are allocated from a slab pool, so entries
+ * created together are adjacent in memory and a whole term is freed slab by
+ * slab. A session repeating over several weeks is one entry holding its set
+ * of weeks, and is only expanded into one row per week on export.
+ *
+ * Changes are made by one thread at a time, which also uses the query
+ * methods here. Other threads read a published version instead: after each
+ * change, or once at the end of an UpdateBatch, a copy of the working
+ * version replaces the published one in a single pointer swap, and readers
+ * hold it by reference count for as long as they use its entries. A
+ * deleted entry is retired with the epoch of the last version that may
+ * list it, and is only freed once every version up to that epoch has been
+ * released.
  */
 class TimetableManager {
 private:
     std::string academicYear;
     std::string semester;
-    std::vector<TimetableEntry*> timetableEntries;
+    SlabPool<TimetableEntry> entryPool;  // Owns every entry in working, and retired entries
+    TimetableVersion working;            // Entries and indices as changed so far
     ConflictDetector conflictDetector;
 
+    // Latest published copy of working and its epoch; the mutex only guards swapping and copying the pointer
+    std::shared_ptr<const TimetableVersion> published;
+    mutable std::mutex publishedMutex;
+    std::uint64_t publishedEpoch;
+
+    // Epochs of the published versions still held, shared with the versions so they can outlive the manager
+    struct LiveEpochs {
+        std::mutex mutex;
+        std::set<std::uint64_t> epochs;
+    };
+    std::shared_ptr<LiveEpochs> liveEpochs;
+
+    // Deleted entries, each with the epoch of the last version that may list it
+    std::vector<std::pair<std::uint64_t, TimetableEntry*>> retired;
+
+    // Open UpdateBatch scopes, and whether working has changed since it was last published
+    int batchDepth;
+    bool unpublished;
+
+    // Entries by ID, and the number used for the next generated ID
+    std::unordered_map<std::string, TimetableEntry*> entriesByID;
+    int nextEntryNumber;
+
+    // Snapshots and journal replay restore entries with their saved IDs and ID counter
+    friend class Snapshot;
+    friend class Journal;
+
     // Helper function to generate unique entry IDs
-    std::string generateEntryID() const;
+    std::string generateEntryID();
+
+    // Helper function to keep generated IDs clear of an ID that was restored or imported
+    void reserveEntryID(const std::string& entryID);
+
+    // Helper function to check an entry could be added without double booking its lecturer or room in any of its weeks
+    bool canSchedule(const WeekSet& weeks, Module* mod, Lecturer* lec, Room* rm, StudentGroup* group,
+                     SessionType* session, const TimeSlot& time) const;
+
+    // Helper function to create, book and index an entry that passed canSchedule
+    TimetableEntry* storeEntry(const std::string& entryID, const WeekSet& weeks, Module* mod, Lecturer* lec,
+                               Room* rm, StudentGroup* group, SessionType* session, const TimeSlot& time);
+
+    // Helper function to publish working after a change, or mark it unpublished inside an UpdateBatch
+    void changed();
+
+    // Helper function to publish a copy of working and free retired entries no version can list any more
+    void publish();
 
 public:
+    /**
+     * @class UpdateBatch
+     * @brief Defers publishing changes until the end of its scope
+     *
+     * Changes made while a batch is open are visible to the manager's own
+     * query methods at once, and to readers of the published version when
+     * the outermost batch closes. Bulk changes then copy the working version
+     * once rather than once per change.
+     */
+    class UpdateBatch {
+    private:
+        TimetableManager& manager;
+
+    public:
+        /**
+         * @brief Constructor, opens a batch
+         * @param timetable Timetable manager whose changes are deferred
+         */
+        explicit UpdateBatch(TimetableManager& timetable);
+
+        /**
+         * @brief Destructor, publishes the changes if this is the outermost batch
+         */
+        ~UpdateBatch();
+
+        UpdateBatch(const UpdateBatch&) = delete;
+        UpdateBatch& operator=(const UpdateBatch&) = delete;
+    };
+
     /**
      * @brief Constructor for TimetableManager class
      * @param year Academic year (e.g., "2024-2025")
@@ -43,9 +182,25 @@ public:
 
     /**
      * @brief Destructor to clean up owned timetable entries
+     *
+     * No published version may still be in use by another thread.
      */
     ~TimetableManager();
 
+    TimetableManager(const TimetableManager&) = delete;
+    TimetableManager& operator=(const TimetableManager&) = delete;
+
+    /**
+     * @brief Gets the latest published version of the timetable
+     *
+     * This is the only part of the manager that other threads may use while
+     * it is being changed. The version never changes, and its entries stay
+     * valid for as long as the returned pointer is held.
+     *
+     * @return Latest published version
+     */
+    std::shared_ptr<const TimetableVersion> getPublishedVersion() const;
+
     /**
      * @brief Gets the academic year
      * @return Academic year string
@@ -66,15 +221,37 @@ public:
      * @param rm Room pointer
      * @param group Student group pointer
      * @param session Session type pointer
-     * @param time Time slot pointer
+     * @param time Time slot, copied into the entry
      * @return Pointer to created timetable entry, or nullptr if creation failed
      */
     TimetableEntry* createEntry(int week, Module* mod, Lecturer* lec,
                                Room* rm, StudentGroup* group,
-                               SessionType* session, TimeSlot* time);
+                               SessionType* session, const TimeSlot& time);
+
+    /**
+     * @brief Creates one timetable entry for a session held in several weeks
+     *
+     * The lecturer and room are checked and booked for every week in the
+     * set, and conflicts are probed once for the whole entry.
+     *
+     * @param weeks Weeks the session runs in (1-53)
+     * @param mod Module pointer
+     * @param lec Lecturer pointer
+     * @param rm Room pointer
+     * @param group Student group pointer
+     * @param session Session type pointer
+     * @param time Time slot, the same in every week
+     * @return Pointer to created timetable entry, or nullptr if creation failed
+     */
+    TimetableEntry* createRecurringEntry(const WeekSet& weeks, Module* mod, Lecturer* lec,
+                                         Room* rm, StudentGroup* group,
+                                         SessionType* session, const TimeSlot& time);
 
     /**
      * @brief Searches for timetable entries matching criteria
+     *
+     * Answered from the working version; see TimetableVersion::searchTimetable.
+     *
      * @param week Week number (-1 for all weeks)
      * @param moduleCode Module code (empty for all modules)
      * @param roomID Room ID (empty for all rooms)
@@ -88,39 +265,100 @@ public:
 
     /**
      * @brief Exports timetable data to a CSV file
+     *
+     * Each entry is written as one row per week it runs in, all with the
+     * entry's ID. Fields containing commas, quotes or line breaks are quoted.
+     *
      * @param filename Name of the output file
      * @return True if export successful, false otherwise
      */
     bool exportToCSV(const std::string& filename) const;
 
+    /**
+     * @brief Imports timetable entries from a CSV file written by exportToCSV
+     *
+     * Modules are matched by code, rooms by ID, and lecturers, student groups
+     * and session types by name. Entry IDs are kept, and rows sharing an ID
+     * and every field but the week become one entry running in all their
+     * weeks. Rows that cannot be resolved, reuse an existing ID, repeat a
+     * week or differ from the first row of their ID are skipped, as are all
+     * rows of an entry that would double book a lecturer or room. Conflicts
+     * are rescanned once after all rows are loaded.
+     *
+     * @param filename Name of the input file
+     * @param modules Modules that rows may refer to
+     * @param lecturers Lecturers that rows may refer to
+     * @param rooms Rooms that rows may refer to
+     * @param groups Student groups that rows may refer to
+     * @param sessionTypes Session types that rows may refer to
+     * @param summary Optional counts of rows read, imported and skipped
+     * @return True if the file was read, false if it could not be opened or has the wrong header
+     */
+    bool importFromCSV(const std::string& filename,
+                       const std::vector<Module*>& modules,
+                       const std::vector<Lecturer*>& lecturers,
+                       const std::vector<Room*>& rooms,
+                       const std::vector<StudentGroup*>& groups,
+                       const std::vector<SessionType*>& sessionTypes,
+                       ImportSummary* summary = nullptr);
+
+    /**
+     * @brief Finds the best rooms and times a session could be booked at
+     *
+     * Every allowed (day, start) is checked as one batch against the
+     * lecturer's calendar and the group's entries for each week, and the
+     * times left are then checked against each large enough room's calendar.
+     * Rooms are tried from fewest to most empty seats, and the search stops
+     * once no further room can beat the options found. Nothing is booked.
+     *
+     * @param query Session to place
+     * @param rooms Rooms the session may be held in
+     * @return Up to query.limit options, best score first, then by day, start and room order
+     */
+    std::vector<SlotOption> findFreeSlots(const SlotQuery& query, const std::vector<Room*>& rooms) const;
+
     /**
      * @brief Gets all timetable entries for a specific student group
+
      * @param groupID Student group ID
      * @param week Week number (-1 for all weeks)
      * @return Vector of pointers to matching timetable entries
      */
-    std::vector<TimetableEntry*> getTimetableForGroup(const std::string& groupID, int week = -1) const;
+    std::vector<TimetableEntry*> getTimetableForGroup(std::string_view groupID, int week = -1) const;
 
     /**
      * @brief Gets all timetable entries for a specific lecturer
+
      * @param lecturerID Lecturer ID
      * @param week Week number (-1 for all weeks)
      * @return Vector of pointers to matching timetable entries
      */
-    std::vector<TimetableEntry*> getTimetableForLecturer(const std::string& lecturerID, int week = -1) const;
+    std::vector<TimetableEntry*> getTimetableForLecturer(std::string_view lecturerID, int week = -1) const;
 
     /**
      * @brief Gets all timetable entries for a specific room
+
      * @param roomID Room ID
      * @param week Week number (-1 for all weeks)
      * @return Vector of pointers to matching timetable entries
      */
-    std::vector<TimetableEntry*> getTimetableForRoom(const std::string& roomID, int week = -1) const;
+    std::vector<TimetableEntry*> getTimetableForRoom(std::string_view roomID, int week = -1) const;
 
     /**
-     * @brief Checks for conflicts in the timetable
+     * @brief Rescans the whole timetable for conflicts
+     *
+     * Conflicts are kept up to date as entries are created and deleted, so
+     * this full rescan is only needed to rebuild that state from scratch.
+     *
+     * @param threads Most threads to scan on, such as std::thread::hardware_concurrency()
      */
-    void checkForConflicts();
+    void checkForConflicts(unsigned int threads = 1);
+
+    /**
+     * @brief Verifies the incrementally maintained conflicts against a full rescan
+     * @return True if the maintained conflicts are consistent, false otherwise
+     */
+    bool verifyConflicts() const;
 
     /**
      * @brief Checks if any conflicts exist in the timetable
@@ -130,9 +368,23 @@ public:
 
     /**
      * @brief Gets all conflicts in the timetable
-     * @return Vector of pairs of conflicting timetable entries
+     * @return View of the conflicts, valid until the timetable next changes
+     */
+    std::span<const Conflict> getConflicts() const;
+
+    /**
+     * @brief Gets the number of conflicts involving one kind of shared resource
+     * @param kind Kind of resource
+     * @return Number of conflicts with that kind among their kinds
+     */
+    size_t getConflictCount(Conflict::Kind kind) const;
+
+    /**
+     * @brief Suggests a resolution for a conflict
+     * @param conflict Conflict between two timetable entries
+     * @return String containing suggested resolution
      */
-    std::vector<std::pair<TimetableEntry*, TimetableEntry*>> getConflicts() const;
+    std::string suggestResolution(const Conflict& conflict) const;
 
     /**
      * @brief Deletes a timetable entry
@@ -145,7 +397,7 @@ public:
      * @brief Gets all timetable entries
      * @return Vector of pointers to all timetable entries
      */
-    const std::vector<TimetableEntry*>& getAllEntries() const;
+    std::vector<TimetableEntry*> getAllEntries() const;
 };
 
 #endif // TIMETABLE_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,153 @@
+
+
+#ifndef TIMETABLE_VERSION_H
+#define TIMETABLE_VERSION_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "EntryColumns.h"
+#include "StringInterner.h"
+#include "TimetableEntry.h"
+
+/**
+ * @class TimetableVersion
+ * @brief The timetable's entries and lookup indices as of one moment
+ *
+ * Entries are indexed by student group, lecturer, room and module, so
+ * lookups only touch matching entries. An entry running in several weeks
+ * is indexed once per key, and a lookup for one week keeps the entries
+ * whose week mask contains it. Results for one week are in creation
+ * order; results spanning all weeks are ordered by first week, then by
+ * creation. Each key keeps its entries in both orders, so neither lookup
+ * sorts. A lookup for one week tests every entry of its key rather than
+ * reading a list for that week: a key holds one group's, lecturer's or
+ * room's sessions, each test is one mask AND, and per-week lists would
+ * store an entry once for every week it runs in. A columnar copy of each
+ * entry's weeks, times and references backs searches that are too broad
+ * for the indices.
+ *
+ * TimetableManager edits one working version and publishes copies of it
+ * that are never changed again, so any number of threads can query a
+ * published version while the manager goes on editing. A copy shares the
+ * index chunks, entry lists and column chunks of the working version
+ * rather than duplicating them; the working version copies one the first
+ * time it changes it afterwards, so a change costs about the size of the
+ * lists and chunks it touches.
+ */
+class TimetableVersion {
+private:
+    // Index nodes are shared between versions and copied by the first change after a publication;
+    // a node stamped with the version's own epoch was made since then and may be changed in place
+    struct EntryList {
+        std::uint64_t epoch;
+        std::vector<TimetableEntry*> entries;       // Entries for one key in creation order, whatever their weeks
+        std::vector<TimetableEntry*> byFirstWeek;   // The same entries by first week, then creation
+    };
+
+    // Lists of a run of symbols; chunks are shared and copied like the lists they point to
+    static constexpr size_t INDEX_CHUNK_SYMBOLS = 64;
+    struct IndexChunk {
+        std::uint64_t epoch;
+        std::shared_ptr<EntryList> lists[INDEX_CHUNK_SYMBOLS];
+    };
+
+    // Index chunks by symbol / INDEX_CHUNK_SYMBOLS, null where no symbol of the run has entries
+    using Index = std::vector<std::shared_ptr<IndexChunk>>;
+
+    std::uint64_t epoch;                 // Number of the publication this version is, or will become
+    EntryColumns columns;                // All entries in creation order, one row each
+    Index groupIndex;
+    Index lecturerIndex;
+    Index roomIndex;
+    Index moduleIndex;
+
+    // The manager edits its working version in place
+    friend class TimetableManager;
+    friend class Snapshot;
+
+    // Helper function to get a node this version may change, copying it if it is shared
+    template <typename Node>
+    Node& own(std::shared_ptr<Node>& node);
+
+    // Helper function to get the list of a symbol this version may change, copying its chunk and itself if shared
+    EntryList& ownList(Index& index, StringInterner::Symbol symbol);
+
+    // Helper functions to add an entry to, or remove it from, the columns and indices
+    void add(TimetableEntry* entry);
+    void remove(TimetableEntry* entry);
+
+    // Helper function to look up the entries for an ID, or nullptr if the ID has no entries
+    static const EntryList* findList(const Index& index, std::string_view key);
+
+    // Helper function to collect the entries of a list running in one week, or all of them if week is -1
+    static std::vector<TimetableEntry*> collect(const EntryList* list, int week);
+
+public:
+    /**
+     * @brief Constructor for an empty TimetableVersion
+     */
+    TimetableVersion();
+
+    /**
+     * @brief Gets the number of the publication this version came from
+     * @return Epoch; publications are numbered from 1
+     */
+    std::uint64_t getEpoch() const;
+
+    /**
+     * @brief Searches for timetable entries matching criteria
+     *
+     * The most selective of the given criteria is answered from an index.
+     * If its entries are not much fewer than the whole timetable, the
+     * criteria are instead matched by a scan over the entry columns.
+     *
+     * @param week Week number (-1 for all weeks)
+     * @param moduleCode Module code (empty for all modules)
+     * @param roomID Room ID (empty for all rooms)
+     * @param lecturerID Lecturer ID (empty for all lecturers)
+     * @return Vector of pointers to matching timetable entries
+     */
+    std::vector<TimetableEntry*> searchTimetable(int week, const std::string& moduleCode,
+                                                 const std::string& roomID, const std::string& lecturerID) const;
+
+    /**
+     * @brief Gets all timetable entries for a specific student group
+     * @param groupID Student group ID
+     * @param week Week number (-1 for all weeks)
+     * @return Vector of pointers to matching timetable entries
+     */
+    std::vector<TimetableEntry*> getTimetableForGroup(std::string_view groupID, int week) const;
+
+    /**
+     * @brief Gets all timetable entries for a specific lecturer
+     * @param lecturerID Lecturer ID
+     * @param week Week number (-1 for all weeks)
+     * @return Vector of pointers to matching timetable entries
+     */
+    std::vector<TimetableEntry*> getTimetableForLecturer(std::string_view lecturerID, int week) const;
+
+    /**
+     * @brief Gets all timetable entries for a specific room
+     * @param roomID Room ID
+     * @param week Week number (-1 for all weeks)
+     * @return Vector of pointers to matching timetable entries
+     */
+    std::vector<TimetableEntry*> getTimetableForRoom(std::string_view roomID, int week) const;
+
+    /**
+     * @brief Gets the entry columns
+     * @return Columns holding every entry in creation order
+     */
+    const EntryColumns& getColumns() const;
+
+    /**
+     * @brief Gets all timetable entries
+     * @return Vector of pointers to all timetable entries, in creation order
+     */
+    std::vector<TimetableEntry*> getEntries() const;
+};
+
+#endif // TIMETABLE_VERSION_H
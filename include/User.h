@@ -4,8 +4,10 @@
 #define USER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include "StringInterner.h"
 
 /**
  * @class User
@@ -16,10 +18,14 @@
  */
 class User {
 protected:
-    std::string userID;
-    std::string name;
+    StringInterner::Symbol userID;
+    StringInterner::Symbol name;
     std::string password; // In a real system, this would be stored securely (hashed and salted)
 
+    // Snapshots save and restore passwords, and journal replay reapplies password changes
+    friend class Snapshot;
+    friend class Journal;
+
 public:
     /**
      * @brief Constructor for User class
@@ -51,13 +57,19 @@ public:
      * @brief Gets the user ID
      * @return User ID string
      */
-    std::string getUserID() const;
+    std::string_view getUserID() const;
+
+    /**
+     * @brief Gets the interned user ID
+     * @return Symbol of the user ID
+     */
+    StringInterner::Symbol getUserSymbol() const;
 
     /**
      * @brief Gets the user's name
      * @return User's name string
      */
-    std::string getName() const;
+    std::string_view getName() const;
 
     /**
      * @brief Change user's password
@@ -8,16 +8,28 @@
 #include "User.h"
 #include "Admin.h"
 #include "Student.h"
+#include "FlatIndex.h"
 
 /**
  * @class UserManager
  * @brief Manages user authentication and registration in the timetabling system
  *
  * The UserManager class handles user creation, authentication, and retrieval.
+ * Admins are owned here and indexed by ID. Students live in the entity
+ * registry, the one store the admin operations use as well, so logging in
+ * is a hash lookup and listing admins or students returns a list that
+ * already exists.
  */
 class UserManager {
 private:
-    std::vector<User*> users;
+    std::vector<Admin*> admins;
+    FlatIndex<Admin*> adminsByID;
+
+    // Snapshots restore admins directly, in their saved order
+    friend class Snapshot;
+
+    // Helper function to index a new admin and add it to the admin list
+    bool addAdmin(Admin* admin);
 
 public:
     /**
@@ -72,16 +84,21 @@ public:
 
     /**
      * @brief Gets all admin users
-     * @return Vector of pointers to admin users
+     * @return Vector of pointers to admin users, in registration order
      */
-    std::vector<Admin*> getAllAdmins() const;
+    const std::vector<Admin*>& getAllAdmins() const;
 
     /**
-     * @brief Gets all student users
-     * @return Vector of pointers to student users
+     * @brief Gets all student users, however they were registered
+     * @return Vector of pointers to student users, in registration order
      */
-    std::vector<Student*> getAllStudents() const;
+    const std::vector<Student*>& getAllStudents() const;
 
+    /**
+     * @brief Deletes a user
+     * @param userId User ID to delete
+     * @return True if the user was found and deleted, false otherwise
+     */
     bool deleteUser(const std::string& userId);
 };
 
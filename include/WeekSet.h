@@ -0,0 +1,135 @@
+
+
+#ifndef WEEK_SET_H
+#define WEEK_SET_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @class WeekSet
+ * @brief A set of teaching weeks stored as a 64-bit mask
+ *
+ * Bit w is set when week w is in the set, for weeks 1 to 53. A session that
+ * repeats every week of a term, less a reading week, is then one mask
+ * rather than a list of weeks, and testing two sessions for a shared week is
+ * a single AND.
+ */
+class WeekSet {
+public:
+    /**
+     * @brief First and last week a set can hold
+     */
+    static constexpr int FIRST_WEEK = 1;
+    static constexpr int LAST_WEEK = 53;
+
+private:
+    std::uint64_t bits;
+
+public:
+    /**
+     * @brief Constructor for WeekSet class
+     * @param mask Week mask, with bit w set for week w
+     */
+    explicit WeekSet(std::uint64_t mask = 0);
+
+    /**
+     * @brief Makes a set holding one week
+     * @param week Week number (1-53); any other value gives an empty set
+     * @return Set holding the week
+     */
+    static WeekSet single(int week);
+
+    /**
+     * @brief Makes a set holding a range of weeks
+     * @param first First week, inclusive
+     * @param last Last week, inclusive
+     * @return Set holding the weeks of the range that lie in 1-53
+     */
+    static WeekSet range(int first, int last);
+
+    /**
+     * @brief Parses a list of weeks and week ranges such as "1-6, 8-12"
+     * @param text Comma separated weeks and first-last ranges
+     * @param weeks Set to the weeks listed
+     * @return True if the text was valid and lists at least one week, false otherwise
+     */
+    static bool parse(std::string_view text, WeekSet& weeks);
+
+    /**
+     * @brief Checks if a week is in the set
+     * @param week Week number
+     * @return True if the week is in the set, false otherwise
+     */
+    bool contains(int week) const;
+
+    /**
+     * @brief Adds a week to the set
+     * @param week Week number (1-53); any other value is ignored
+     */
+    void add(int week);
+
+    /**
+     * @brief Removes a week from the set
+     * @param week Week number
+     */
+    void remove(int week);
+
+    /**
+     * @brief Checks if the set holds no weeks
+     * @return True if the set is empty, false otherwise
+     */
+    bool empty() const;
+
+    /**
+     * @brief Checks the set is one a session can be scheduled in
+     * @return True if the set is not empty and holds only weeks 1-53, false otherwise
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Gets the number of weeks in the set
+     * @return Number of weeks
+     */
+    int count() const;
+
+    /**
+     * @brief Gets the earliest week in the set
+     * @return First week, or 0 if the set is empty
+     */
+    int first() const;
+
+    /**
+     * @brief Gets the next week in the set after a given week
+     *
+     * Visit every week with for (int w = weeks.first(); w; w = weeks.next(w)).
+     *
+     * @param week Week to continue after
+     * @return Next week in the set, or 0 if there is none
+     */
+    int next(int week) const;
+
+    /**
+     * @brief Checks if two sets share a week
+     * @param other Set to check against
+     * @return True if some week is in both sets, false otherwise
+     */
+    bool intersects(const WeekSet& other) const;
+
+    /**
+     * @brief Gets the week mask
+     * @return Mask with bit w set for week w
+     */
+    std::uint64_t getBits() const;
+
+    /**
+     * @brief Formats the set as runs of consecutive weeks
+     * @return String such as "1-6, 8-12", or "none" if the set is empty
+     */
+    std::string toString() const;
+
+    bool operator==(const WeekSet& other) const = default;
+};
+
+#endif // WEEK_SET_H
@@ -8,102 +8,101 @@
 #include "../include/StudentGroup.h"
 #include "../include/TimeSlot.h"
 #include "../include/TimetableManager.h"
+#include "../include/UserManager.h"
+#include "../include/EntityRegistry.h"
+#include "../include/Journal.h"
+#include "../include/GlobalVariables.h"
 #include <iostream>
-
-// Global collections for simplicity in this demonstration
-extern std::vector<Module*> g_modules;
-extern std::vector<Student*> g_students;
-extern std::vector<Lecturer*> g_lecturers;
-extern std::vector<Room*> g_rooms;
-extern std::vector<SessionType*> g_sessionTypes;
-extern std::vector<StudentGroup*> g_studentGroups;
+#include <thread>
 
 Admin::Admin(const std::string& id, const std::string& name, const std::string& pwd, const std::string& dept)
-    : User(id, name, pwd), department(dept) {
+    : User(id, name, pwd), department(g_strings.intern(dept)) {
 }
 
 std::string Admin::getUserDetails() const {
-    return User::getUserDetails() + ", Department: " + department;
+    std::string details = User::getUserDetails();
+    details.append(", Department: ").append(getDepartment());
+    return details;
 }
 
-std::string Admin::getDepartment() const {
-    return department;
+std::string_view Admin::getDepartment() const {
+    return g_strings.view(department);
 }
 
 Module* Admin::createModule(const std::string& moduleCode, const std::string& title, const std::string& description) {
     // Check if module code already exists
-    for (auto& module : g_modules) {
-        if (module->getModuleCode() == moduleCode) {
-            std::cout << "Module with code " << moduleCode << " already exists." << std::endl;
-            return nullptr;
-        }
+    if (g_registry.findModule(moduleCode)) {
+        std::cout << "Module with code " << moduleCode << " already exists." << std::endl;
+        return nullptr;
     }
 
     // Create new module and add to collection
     Module* newModule = new Module(moduleCode, title, description);
-    g_modules.push_back(newModule);
+    g_registry.addModule(newModule);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::CreateModule)
+                              .str(moduleCode).str(title).str(description));
+    }
     std::cout << "Module created: " << newModule->getDetails() << std::endl;
     return newModule;
 }
 
 bool Admin::createStudentGroup(const std::string& groupID, const std::string& groupName) {
     // Check if group ID already exists
-    for (auto& group : g_studentGroups) {
-        if (group->getGroupID() == groupID) {
-            std::cout << "Student group with ID " << groupID << " already exists." << std::endl;
-            return false;
-        }
+    if (g_registry.findStudentGroup(groupID)) {
+        std::cout << "Student group with ID " << groupID << " already exists." << std::endl;
+        return false;
     }
 
     // Create new student group and add to collection
     StudentGroup* newGroup = new StudentGroup(groupID, groupName);
-    g_studentGroups.push_back(newGroup);
+    g_registry.addStudentGroup(newGroup);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::CreateStudentGroup).str(groupID).str(groupName));
+    }
     std::cout << "Student group created: " << groupName << " (" << groupID << ")" << std::endl;
     return true;
 }
 
 bool Admin::defineSessionType(const std::string& typeID, const std::string& typeName) {
     // Check if session type ID already exists
-    for (auto& type : g_sessionTypes) {
-        if (type->getTypeID() == typeID) {
-            std::cout << "Session type with ID " << typeID << " already exists." << std::endl;
-            return false;
-        }
+    if (g_registry.findSessionType(typeID)) {
+        std::cout << "Session type with ID " << typeID << " already exists." << std::endl;
+        return false;
     }
 
     // Create new session type and add to collection
     SessionType* newType = new SessionType(typeID, typeName);
-    g_sessionTypes.push_back(newType);
+    g_registry.addSessionType(newType);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::DefineSessionType).str(typeID).str(typeName));
+    }
     std::cout << "Session type created: " << typeName << " (" << typeID << ")" << std::endl;
     return true;
 }
 
-Student* Admin::registerStudent(const std::string& id, const std::string& name, const std::string& pwd,
-                              const std::string& studentNumber, const std::string& course) {
-    // Check if student ID already exists
-    for (auto& student : g_students) {
-        if (student->getUserID() == id || student->getStudentNumber() == studentNumber) {
-            std::cout << "Student with ID " << id << " or number " << studentNumber << " already exists." << std::endl;
-            return nullptr;
-        }
+Student* Admin::registerStudent(const UserManager& userManager, const std::string& id, const std::string& name,
+                              const std::string& pwd, const std::string& studentNumber, const std::string& course) {
+    // Check if the ID is taken by any user, or the student number by another student
+    if (userManager.getUserById(id) || g_registry.findStudentByNumber(studentNumber)) {
+        std::cout << "User with ID " << id << " or student with number " << studentNumber << " already exists." << std::endl;
+        return nullptr;
     }
 
     // Create new student and add to collection
     Student* newStudent = new Student(id, name, pwd, studentNumber, course);
-    g_students.push_back(newStudent);
+    g_registry.addStudent(newStudent);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::AdminRegisterStudent)
+                              .str(id).str(name).str(pwd).str(studentNumber).str(course));
+    }
     std::cout << "Student registered: " << newStudent->getUserDetails() << std::endl;
     return newStudent;
 }
 
-bool Admin::assignStudentToGroup(const std::string& studentID, const std::string& groupID) {
+bool Admin::assignStudentToGroup(std::string_view studentID, std::string_view groupID) {
     // Find student
-    Student* student = nullptr;
-    for (auto& s : g_students) {
-        if (s->getUserID() == studentID) {
-            student = s;
-            break;
-        }
-    }
+    Student* student = g_registry.findStudent(studentID);
 
     if (!student) {
         std::cout << "Student with ID " << studentID << " not found." << std::endl;
@@ -111,13 +110,7 @@ bool Admin::assignStudentToGroup(const std::string& studentID, const std::string
     }
 
     // Find group
-    StudentGroup* group = nullptr;
-    for (auto& g : g_studentGroups) {
-        if (g->getGroupID() == groupID) {
-            group = g;
-            break;
-        }
-    }
+    StudentGroup* group = g_registry.findStudentGroup(groupID);
 
     if (!group) {
         std::cout << "Student group with ID " << groupID << " not found." << std::endl;
@@ -125,36 +118,33 @@ bool Admin::assignStudentToGroup(const std::string& studentID, const std::string
     }
 
     // Assign student to group
-    group->addStudent(student);
+    if (group->addStudent(student) && g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::AssignStudentToGroup).str(studentID).str(groupID));
+    }
     std::cout << "Student " << student->getName() << " assigned to group " << group->getGroupName() << std::endl;
     return true;
 }
 
 bool Admin::registerLecturer(const std::string& id, const std::string& name, const std::string& department) {
     // Check if lecturer ID already exists
-    for (auto& lecturer : g_lecturers) {
-        if (lecturer->getLecturerID() == id) {
-            std::cout << "Lecturer with ID " << id << " already exists." << std::endl;
-            return false;
-        }
+    if (g_registry.findLecturer(id)) {
+        std::cout << "Lecturer with ID " << id << " already exists." << std::endl;
+        return false;
     }
 
     // Create new lecturer and add to collection
     Lecturer* newLecturer = new Lecturer(id, name, department);
-    g_lecturers.push_back(newLecturer);
+    g_registry.addLecturer(newLecturer);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::RegisterLecturer).str(id).str(name).str(department));
+    }
     std::cout << "Lecturer registered: " << newLecturer->getName() << " (" << department << ")" << std::endl;
     return true;
 }
 
-bool Admin::assignLecturerToModule(const std::string& lecturerID, const std::string& moduleCode) {
+bool Admin::assignLecturerToModule(std::string_view lecturerID, std::string_view moduleCode) {
     // Find lecturer
-    Lecturer* lecturer = nullptr;
-    for (auto& l : g_lecturers) {
-        if (l->getLecturerID() == lecturerID) {
-            lecturer = l;
-            break;
-        }
-    }
+    Lecturer* lecturer = g_registry.findLecturer(lecturerID);
 
     if (!lecturer) {
         std::cout << "Lecturer with ID " << lecturerID << " not found." << std::endl;
@@ -162,13 +152,7 @@ bool Admin::assignLecturerToModule(const std::string& lecturerID, const std::str
     }
 
     // Find module
-    Module* module = nullptr;
-    for (auto& m : g_modules) {
-        if (m->getModuleCode() == moduleCode) {
-            module = m;
-            break;
-        }
-    }
+    Module* module = g_registry.findModule(moduleCode);
 
     if (!module) {
         std::cout << "Module with code " << moduleCode << " not found." << std::endl;
@@ -176,40 +160,37 @@ bool Admin::assignLecturerToModule(const std::string& lecturerID, const std::str
     }
 
     // Assign lecturer to module
-    lecturer->assignModule(module);
+    if (lecturer->assignModule(module) && g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::AssignLecturerToModule).str(lecturerID).str(moduleCode));
+    }
     std::cout << "Lecturer " << lecturer->getName() << " assigned to module " << module->getTitle() << std::endl;
     return true;
 }
 
 bool Admin::addRoom(const std::string& roomID, const std::string& location, int capacity) {
     // Check if room ID already exists
-    for (auto& room : g_rooms) {
-        if (room->getRoomID() == roomID) {
-            std::cout << "Room with ID " << roomID << " already exists." << std::endl;
-            return false;
-        }
+    if (g_registry.findRoom(roomID)) {
+        std::cout << "Room with ID " << roomID << " already exists." << std::endl;
+        return false;
     }
 
     // Create new room and add to collection
     Room* newRoom = new Room(roomID, location, capacity);
-    g_rooms.push_back(newRoom);
+    g_registry.addRoom(newRoom);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::AddRoom).str(roomID).str(location).i32(capacity));
+    }
     std::cout << "Room added: " << newRoom->getDetails() << std::endl;
     return true;
 }
 
-bool Admin::createTimetableEntry(TimetableManager& timetableManager, int week,
-                                const std::string& moduleCode, const std::string& lecturerID,
-                                const std::string& roomID, const std::string& groupID,
-                                const std::string& sessionTypeID, const std::string& day,
+bool Admin::createTimetableEntry(TimetableManager& timetableManager, const WeekSet& weeks,
+                                std::string_view moduleCode, std::string_view lecturerID,
+                                std::string_view roomID, std::string_view groupID,
+                                std::string_view sessionTypeID, const std::string& day,
                                 const std::string& startTime, const std::string& endTime) {
     // Find module
-    Module* module = nullptr;
-    for (auto& m : g_modules) {
-        if (m->getModuleCode() == moduleCode) {
-            module = m;
-            break;
-        }
-    }
+    Module* module = g_registry.findModule(moduleCode);
 
     if (!module) {
         std::cout << "Module with code " << moduleCode << " not found." << std::endl;
@@ -217,13 +198,7 @@ bool Admin::createTimetableEntry(TimetableManager& timetableManager, int week,
     }
 
     // Find lecturer
-    Lecturer* lecturer = nullptr;
-    for (auto& l : g_lecturers) {
-        if (l->getLecturerID() == lecturerID) {
-            lecturer = l;
-            break;
-        }
-    }
+    Lecturer* lecturer = g_registry.findLecturer(lecturerID);
 
     if (!lecturer) {
         std::cout << "Lecturer with ID " << lecturerID << " not found." << std::endl;
@@ -231,13 +206,7 @@ bool Admin::createTimetableEntry(TimetableManager& timetableManager, int week,
     }
 
     // Find room
-    Room* room = nullptr;
-    for (auto& r : g_rooms) {
-        if (r->getRoomID() == roomID) {
-            room = r;
-            break;
-        }
-    }
+    Room* room = g_registry.findRoom(roomID);
 
     if (!room) {
         std::cout << "Room with ID " << roomID << " not found." << std::endl;
@@ -245,13 +214,7 @@ bool Admin::createTimetableEntry(TimetableManager& timetableManager, int week,
     }
 
     // Find student group
-    StudentGroup* group = nullptr;
-    for (auto& g : g_studentGroups) {
-        if (g->getGroupID() == groupID) {
-            group = g;
-            break;
-        }
-    }
+    StudentGroup* group = g_registry.findStudentGroup(groupID);
 
     if (!group) {
         std::cout << "Student group with ID " << groupID << " not found." << std::endl;
@@ -259,13 +222,7 @@ bool Admin::createTimetableEntry(TimetableManager& timetableManager, int week,
     }
 
     // Find session type
-    SessionType* sessionType = nullptr;
-    for (auto& s : g_sessionTypes) {
-        if (s->getTypeID() == sessionTypeID) {
-            sessionType = s;
-            break;
-        }
-    }
+    SessionType* sessionType = g_registry.findSessionType(sessionTypeID);
 
     if (!sessionType) {
         std::cout << "Session type with ID " << sessionTypeID << " not found." << std::endl;
@@ -273,32 +230,40 @@ bool Admin::createTimetableEntry(TimetableManager& timetableManager, int week,
     }
 
     // Create time slot
-    TimeSlot* timeSlot = new TimeSlot(day, startTime, endTime);
+    TimeSlot timeSlot(day, startTime, endTime);
+
+    if (!timeSlot.isValid()) {
+        std::cout << "Invalid time slot " << day << " " << startTime << " - " << endTime
+                  << ". Use a day name and HH:MM times with the end after the start." << std::endl;
+        return false;
+    }
 
     // Create timetable entry
-    TimetableEntry* entry = timetableManager.createEntry(week, module, lecturer, room, group, sessionType, timeSlot);
+    TimetableEntry* entry = timetableManager.createRecurringEntry(weeks, module, lecturer, room, group, sessionType,
+                                                                  timeSlot);
 
     if (entry) {
         std::cout << "Timetable entry created: " << entry->getEntryDetails() << std::endl;
         return true;
     } else {
         std::cout << "Failed to create timetable entry." << std::endl;
-        delete timeSlot; // Clean up if entry creation failed
         return false;
     }
 }
 
 bool Admin::checkForConflicts(TimetableManager& timetableManager) {
-    timetableManager.checkForConflicts();
+    timetableManager.checkForConflicts(std::thread::hardware_concurrency());
 
     if (timetableManager.hasConflicts()) {
         auto conflicts = timetableManager.getConflicts();
-        std::cout << "Found " << conflicts.size() << " conflicts:" << std::endl;
-
-        for (const auto& conflict : conflicts) {
-            std::cout << "Conflict between:" << std::endl;
-            std::cout << "  1. " << conflict.first->getEntryDetails() << std::endl;
-            std::cout << "  2. " << conflict.second->getEntryDetails() << std::endl;
+        std::cout << "Found " << conflicts.size() << " conflicts ("
+                  << timetableManager.getConflictCount(Conflict::RoomClash) << " room, "
+                  << timetableManager.getConflictCount(Conflict::LecturerClash) << " lecturer, "
+                  << timetableManager.getConflictCount(Conflict::GroupClash) << " student group):" << std::endl;
+
+        for (size_t i = 0; i < conflicts.size(); ++i) {
+            std::cout << std::endl << "Conflict " << (i + 1) << ":" << std::endl;
+            std::cout << timetableManager.suggestResolution(conflicts[i]);
         }
         return true;
     }
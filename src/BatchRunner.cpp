@@ -0,0 +1,421 @@
+#include "../include/BatchRunner.h"
+#include "../include/GlobalVariables.h"
+#include <charconv>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <thread>
+
+namespace {
+
+// Output collected before it is passed on to the console
+const size_t OUTPUT_BLOCK = 1 << 16;
+
+// Holds console output in one block and passes it on only when the block is
+// full or the run ends; the flush std::endl asks for after every message is
+// ignored, so a long script is not slowed down by one console write per line
+class BlockBuffer : public std::streambuf {
+private:
+    std::streambuf* target;
+    std::vector<char> block;
+
+public:
+    explicit BlockBuffer(std::streambuf* console) : target(console), block(OUTPUT_BLOCK) {
+        setp(block.data(), block.data() + block.size());
+    }
+
+    void drain() {
+        target->sputn(pbase(), pptr() - pbase());
+        setp(block.data(), block.data() + block.size());
+        target->pubsync();
+    }
+
+protected:
+    int_type overflow(int_type c) override {
+        drain();
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            sputc(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        return 0;
+    }
+};
+
+// Parses a whole argument as an integer
+bool parseNumber(const std::string& text, int& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Parses a week argument, where * means all weeks
+bool parseWeek(const std::string& text, int& week) {
+    if (text == "*") {
+        week = -1;
+        return true;
+    }
+    return parseNumber(text, week) && week >= WeekSet::FIRST_WEEK && week <= WeekSet::LAST_WEEK;
+}
+
+void printEntries(const std::vector<TimetableEntry*>& entries) {
+    for (auto entry : entries) {
+        std::cout << entry->getEntryDetails() << "\n";
+    }
+    std::cout << "Total: " << entries.size() << std::endl;
+}
+
+}
+
+const BatchRunner::Command BatchRunner::COMMANDS[] = {
+    {"login", 2, 2, false, &BatchRunner::login, "login <userID> <password>"},
+    {"register-admin", 4, 4, true, &BatchRunner::registerAdmin,
+     "register-admin <userID> <name> <password> <department>"},
+    {"register-student", 5, 5, true, &BatchRunner::registerStudent,
+     "register-student <userID> <name> <password> <studentNumber> <course>"},
+    {"delete-user", 1, 1, true, &BatchRunner::deleteUser, "delete-user <userID>"},
+    {"create-module", 2, 3, true, &BatchRunner::createModule, "create-module <code> <title> [description]"},
+    {"create-group", 2, 2, true, &BatchRunner::createGroup, "create-group <groupID> <name>"},
+    {"define-session-type", 2, 2, true, &BatchRunner::defineSessionType, "define-session-type <typeID> <name>"},
+    {"register-lecturer", 3, 3, true, &BatchRunner::registerLecturer,
+     "register-lecturer <lecturerID> <name> <department>"},
+    {"assign-lecturer", 2, 2, true, &BatchRunner::assignLecturer, "assign-lecturer <lecturerID> <moduleCode>"},
+    {"assign-student", 2, 2, true, &BatchRunner::assignStudent, "assign-student <studentID> <groupID>"},
+    {"add-room", 3, 3, true, &BatchRunner::addRoom, "add-room <roomID> <location> <capacity>"},
+    {"create-entry", 9, 9, true, &BatchRunner::createEntry,
+     "create-entry <weeks> <moduleCode> <lecturerID> <roomID> <groupID> <typeID> <day> <start> <end>"},
+    {"delete-entry", 1, 1, true, &BatchRunner::deleteEntry, "delete-entry <entryID>"},
+    {"import-csv", 1, 1, true, &BatchRunner::importCSV, "import-csv <file>"},
+    {"export-csv", 1, 1, true, &BatchRunner::exportCSV, "export-csv <file>"},
+    {"timetable", 2, 3, true, &BatchRunner::showTimetable, "timetable group|lecturer|room <ID> [week]"},
+    {"search", 1, 4, true, &BatchRunner::search, "search <week|*> [moduleCode|*] [roomID|*] [lecturerID|*]"},
+    {"check-conflicts", 0, 0, true, &BatchRunner::checkConflicts, "check-conflicts (fails if there are any)"},
+    {"verify-conflicts", 0, 0, true, &BatchRunner::verifyConflicts,
+     "verify-conflicts (fails if tracked conflicts differ from a full rescan)"},
+    {"check-sweep", 1, 3, true, &BatchRunner::checkSweep,
+     "check-sweep <entries> [threads] [seed] (fails if the conflict sweep on random entries differs from a pairwise scan)"},
+    {"echo", 0, 1000, false, &BatchRunner::echo, "echo [text]"},
+    {"help", 0, 0, false, &BatchRunner::help, "help"},
+};
+
+BatchRunner::BatchRunner(UserManager& users, TimetableManager& timetable, const std::string& snapshot)
+    : userManager(users), timetableManager(timetable), snapshotFile(snapshot), admin(nullptr) {
+}
+
+bool BatchRunner::splitLine(std::string_view line, Arguments& words) {
+    words.clear();
+    size_t pos = 0;
+    while (true) {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) {
+            ++pos;
+        }
+        if (pos == line.size()) {
+            return true;
+        }
+
+        if (line[pos] == '"') {
+            size_t close = line.find('"', pos + 1);
+            if (close == std::string_view::npos) {
+                return false; // Unterminated quote
+            }
+            words.emplace_back(line.substr(pos + 1, close - pos - 1));
+            pos = close + 1;
+        } else {
+            size_t end = line.find_first_of(" \t\r", pos);
+            if (end == std::string_view::npos) {
+                end = line.size();
+            }
+            words.emplace_back(line.substr(pos, end - pos));
+            pos = end;
+        }
+    }
+}
+
+bool BatchRunner::run(std::istream& script, BatchSummary* summary) {
+    BatchSummary counts;
+
+    // Route console output, including the messages printed by the operations, through one block
+    BlockBuffer buffer(std::cout.rdbuf());
+    std::streambuf* console = std::cout.rdbuf(&buffer);
+
+    // The script's own queries see each change at once; other readers see the whole script's changes at the end
+    TimetableManager::UpdateBatch batch(timetableManager);
+
+    std::string line;
+    Arguments words;
+    size_t lineNumber = 0;
+    while (std::getline(script, line)) {
+        ++lineNumber;
+        if (!splitLine(line, words)) {
+            std::cout << "Line " << lineNumber << ": unterminated quote." << std::endl;
+            ++counts.commandsFailed;
+            continue;
+        }
+        if (words.empty() || words[0][0] == '#') {
+            continue;
+        }
+        ++counts.commandsRun;
+
+        const Command* command = nullptr;
+        for (const auto& candidate : COMMANDS) {
+            if (candidate.name == words[0]) {
+                command = &candidate;
+                break;
+            }
+        }
+
+        Arguments args(words.begin() + 1, words.end());
+        bool succeeded = false;
+        if (!command) {
+            std::cout << "Line " << lineNumber << ": unknown command " << words[0] << ". Run help for a list." << std::endl;
+        } else if (args.size() < command->minArguments || args.size() > command->maxArguments) {
+            std::cout << "Line " << lineNumber << ": usage: " << command->usage << std::endl;
+        } else if (command->adminOnly && !admin) {
+            std::cout << "Line " << lineNumber << ": " << command->name << " needs an admin login first." << std::endl;
+        } else {
+            succeeded = (this->*command->run)(args);
+            if (!succeeded) {
+                std::cout << "Line " << lineNumber << ": " << command->name << " failed." << std::endl;
+            }
+        }
+        if (!succeeded) {
+            ++counts.commandsFailed;
+        }
+
+        // Fold a long journal into a fresh snapshot between commands, as the menus do
+        if (g_journal && g_journal->needsCompaction() &&
+            !g_journal->compact(snapshotFile, userManager, timetableManager)) {
+            std::cout << "Warning: failed to compact the journal." << std::endl;
+        }
+    }
+
+    // One full conflict check for the whole script
+    timetableManager.checkForConflicts(std::thread::hardware_concurrency());
+    counts.conflicts = timetableManager.getConflicts().size();
+    std::cout << "Batch finished: " << counts.commandsRun << " commands run, " << counts.commandsFailed
+              << " failed, " << counts.conflicts << " conflict(s) in the timetable." << std::endl;
+
+    buffer.drain();
+    std::cout.rdbuf(console);
+
+    if (summary) {
+        *summary = counts;
+    }
+    return counts.commandsFailed == 0;
+}
+
+bool BatchRunner::login(const Arguments& args) {
+    // Students have no batch commands, so only admins can log in
+    admin = dynamic_cast<Admin*>(userManager.authenticate(args[0], args[1]));
+    if (!admin) {
+        std::cout << "Login failed for " << args[0] << ": not an admin, or the password is wrong." << std::endl;
+        return false;
+    }
+    std::cout << "Logged in as " << admin->getName() << "." << std::endl;
+    return true;
+}
+
+bool BatchRunner::registerAdmin(const Arguments& args) {
+    return userManager.registerAdmin(args[0], args[1], args[2], args[3]) != nullptr;
+}
+
+bool BatchRunner::registerStudent(const Arguments& args) {
+    return admin->registerStudent(userManager, args[0], args[1], args[2], args[3], args[4]) != nullptr;
+}
+
+bool BatchRunner::deleteUser(const Arguments& args) {
+    bool deletingSelf = args[0] == admin->getUserID();
+    if (!userManager.deleteUser(args[0])) {
+        return false;
+    }
+    if (deletingSelf) {
+        admin = nullptr;
+    }
+    return true;
+}
+
+bool BatchRunner::createModule(const Arguments& args) {
+    return admin->createModule(args[0], args[1], args.size() > 2 ? args[2] : "") != nullptr;
+}
+
+bool BatchRunner::createGroup(const Arguments& args) {
+    return admin->createStudentGroup(args[0], args[1]);
+}
+
+bool BatchRunner::defineSessionType(const Arguments& args) {
+    return admin->defineSessionType(args[0], args[1]);
+}
+
+bool BatchRunner::registerLecturer(const Arguments& args) {
+    return admin->registerLecturer(args[0], args[1], args[2]);
+}
+
+bool BatchRunner::assignLecturer(const Arguments& args) {
+    return admin->assignLecturerToModule(args[0], args[1]);
+}
+
+bool BatchRunner::assignStudent(const Arguments& args) {
+    return admin->assignStudentToGroup(args[0], args[1]);
+}
+
+bool BatchRunner::addRoom(const Arguments& args) {
+    int capacity = 0;
+    if (!parseNumber(args[2], capacity) || capacity < 0) {
+        std::cout << "Capacity must be a whole number, not " << args[2] << "." << std::endl;
+        return false;
+    }
+    return admin->addRoom(args[0], args[1], capacity);
+}
+
+bool BatchRunner::createEntry(const Arguments& args) {
+    WeekSet weeks;
+    if (!WeekSet::parse(args[0], weeks)) {
+        std::cout << "Weeks must be numbers from 1 to 53 or ranges such as 1-6,8-12, not " << args[0] << "." << std::endl;
+        return false;
+    }
+    return admin->createTimetableEntry(timetableManager, weeks, args[1], args[2], args[3], args[4], args[5],
+                                       args[6], args[7], args[8]);
+}
+
+bool BatchRunner::deleteEntry(const Arguments& args) {
+    if (!timetableManager.deleteEntry(args[0])) {
+        std::cout << "Timetable entry " << args[0] << " not found." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool BatchRunner::importCSV(const Arguments& args) {
+    ImportSummary summary;
+    if (!timetableManager.importFromCSV(args[0], g_modules, g_lecturers, g_rooms, g_studentGroups,
+                                        g_sessionTypes, &summary)) {
+        std::cout << "Could not read " << args[0] << " as a timetable export." << std::endl;
+        return false;
+    }
+    std::cout << "Imported " << summary.entriesImported << " entries from " << summary.rowsRead << " rows of "
+              << args[0] << "; " << summary.rowsSkipped << " rows skipped." << std::endl;
+    return true;
+}
+
+bool BatchRunner::exportCSV(const Arguments& args) {
+    return timetableManager.exportToCSV(args[0]);
+}
+
+bool BatchRunner::showTimetable(const Arguments& args) {
+    int week = -1;
+    if (args.size() > 2 && !parseWeek(args[2], week)) {
+        std::cout << "Week must be a number from 1 to 53 or *, not " << args[2] << "." << std::endl;
+        return false;
+    }
+
+    if (args[0] == "group") {
+        printEntries(timetableManager.getTimetableForGroup(args[1], week));
+    } else if (args[0] == "lecturer") {
+        printEntries(timetableManager.getTimetableForLecturer(args[1], week));
+    } else if (args[0] == "room") {
+        printEntries(timetableManager.getTimetableForRoom(args[1], week));
+    } else {
+        std::cout << "Timetables are listed by group, lecturer or room, not " << args[0] << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool BatchRunner::search(const Arguments& args) {
+    int week = -1;
+    if (!parseWeek(args[0], week)) {
+        std::cout << "Week must be a number from 1 to 53 or *, not " << args[0] << "." << std::endl;
+        return false;
+    }
+
+    // Criteria left out or given as * match everything
+    auto criterion = [&args](size_t i) {
+        return i < args.size() && args[i] != "*" ? args[i] : std::string();
+    };
+    printEntries(timetableManager.searchTimetable(week, criterion(1), criterion(2), criterion(3)));
+    return true;
+}
+
+bool BatchRunner::checkConflicts(const Arguments&) {
+    return !admin->checkForConflicts(timetableManager);
+}
+
+bool BatchRunner::verifyConflicts(const Arguments&) {
+    if (!timetableManager.verifyConflicts()) {
+        std::cout << "Tracked conflicts differ from a full rescan." << std::endl;
+        return false;
+    }
+    std::cout << "Tracked conflicts match a full rescan (" << timetableManager.getConflicts().size()
+              << " conflict(s))." << std::endl;
+    return true;
+}
+
+bool BatchRunner::checkSweep(const Arguments& args) {
+    int count = 0;
+    int threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int seed = 1;
+    if (!parseNumber(args[0], count) || count < 1 ||
+        (args.size() > 1 && (!parseNumber(args[1], threads) || threads < 1)) ||
+        (args.size() > 2 && !parseNumber(args[2], seed))) {
+        std::cout << "Invalid entry count, thread count or seed." << std::endl;
+        return false;
+    }
+    if (g_modules.empty() || g_lecturers.empty() || g_rooms.empty() || g_studentGroups.empty() ||
+        g_sessionTypes.empty()) {
+        std::cout << "check-sweep needs a module, lecturer, room, student group and session type." << std::endl;
+        return false;
+    }
+
+    // Random sessions among the registered resources, kept apart from the timetable
+    std::mt19937 random(static_cast<std::mt19937::result_type>(seed));
+    auto pick = [&random](const auto& items) { return items[random() % items.size()]; };
+    std::vector<TimetableEntry*> entries;
+    EntryColumns columns;
+    for (int i = 0; i < count; ++i) {
+        int first = WeekSet::FIRST_WEEK + static_cast<int>(random() % 12);
+        WeekSet weeks = WeekSet::range(first, first + static_cast<int>(random() % 4));
+        int start = 8 * 60 + static_cast<int>(random() % 600);
+        int end = start + 15 + static_cast<int>(random() % 120);
+        if (random() % 50 == 0) {
+            end = start - static_cast<int>(random() % 30); // Empty and inverted slots take the sweep's other path
+        }
+        TimeSlot time(static_cast<TimeSlot::Day>(random() % 5), start, end);
+
+        entries.push_back(new TimetableEntry("CHECK" + std::to_string(i), weeks, pick(g_modules), pick(g_lecturers),
+                                             pick(g_rooms), pick(g_studentGroups), pick(g_sessionTypes), time));
+        columns.append(entries.back(), 1);
+
+        // Erased rows must be skipped too
+        if (random() % 10 == 0) {
+            columns.erase(columns.findRow(entries[random() % entries.size()]), 1);
+        }
+    }
+
+    ConflictDetector detector;
+    bool matched = detector.checkSweep(columns, static_cast<unsigned int>(threads));
+    std::cout << "Conflict sweep on 1 and " << threads << " thread(s) "
+              << (matched ? "matches" : "differs from") << " a pairwise scan of "
+              << columns.count() << " random entries." << std::endl;
+
+    for (auto entry : entries) {
+        delete entry;
+    }
+    return matched;
+}
+
+bool BatchRunner::echo(const Arguments& args) {
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::cout << (i ? " " : "") << args[i];
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+bool BatchRunner::help(const Arguments&) {
+    std::cout << "Commands (quote arguments containing spaces):" << std::endl;
+    for (const auto& command : COMMANDS) {
+        std::cout << "  " << command.usage << std::endl;
+    }
+    return true;
+}
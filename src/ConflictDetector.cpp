@@ -1,57 +1,451 @@
 
 #include "../include/ConflictDetector.h"
+#include "../include/ThreadPool.h"
 #include <algorithm>
+#include <bit>
+#include <iomanip>
 #include <sstream>
+#include <unordered_map>
 
-ConflictDetector::ConflictDetector() {
+namespace {
+
+// Rows below which a parallel sweep costs more in thread start-up than it saves
+const size_t PARALLEL_MIN_ROWS = 8192;
+
+// Sweep tasks aimed for per thread, so that threads finishing early have more to take
+const size_t TASKS_PER_THREAD = 4;
+
+// Sets a conflict's overlap from its entries' start and end minutes; an empty or
+// inverted slot still clashes with a slot around it, and overlaps it for no time at all
+void setOverlap(Conflict& conflict, int firstStart, int firstEnd, int secondStart, int secondEnd) {
+    int start = std::max(firstStart, secondStart);
+    int end = std::max(start, std::min(firstEnd, secondEnd));
+    conflict.overlapStart = static_cast<std::uint16_t>(start);
+    conflict.overlapEnd = static_cast<std::uint16_t>(end);
+}
+
+// Formats minutes since midnight as "HH:MM"
+std::string formatMinutes(int minutes) {
+    std::ostringstream ss;
+    ss << std::setfill('0') << std::setw(2) << minutes / 60 << ":" << std::setw(2) << minutes % 60;
+    return ss.str();
+}
+
+}
+
+ConflictDetector::ConflictDetector()
+    : kindCounts{} {
+    // Indexed by the bit position of each Conflict::Kind
     conflictTypes = {"Room Double-booking", "Lecturer Time Conflict", "Student Group Time Conflict"};
 }
 
-void ConflictDetector::detectConflicts(const std::vector<TimetableEntry*>& entries) {
+Conflict ConflictDetector::makeConflict(TimetableEntry* first, TimetableEntry* second) {
+    std::uint8_t kinds = 0;
+    if (first->getRoom()->getRoomSymbol() == second->getRoom()->getRoomSymbol()) {
+        kinds |= Conflict::RoomClash;
+    }
+    if (first->getLecturer()->getLecturerSymbol() == second->getLecturer()->getLecturerSymbol()) {
+        kinds |= Conflict::LecturerClash;
+    }
+    if (first->getStudentGroup()->getGroupSymbol() == second->getStudentGroup()->getGroupSymbol()) {
+        kinds |= Conflict::GroupClash;
+    }
+
+    const TimeSlot* a = first->getTimeSlot();
+    const TimeSlot* b = second->getTimeSlot();
+    Conflict conflict{first, second, 0, 0, kinds};
+    setOverlap(conflict, a->getStartMinutes(), a->getEndMinutes(), b->getStartMinutes(), b->getEndMinutes());
+    return conflict;
+}
+
+void ConflictDetector::countKinds(std::uint8_t kinds, int delta) {
+    for (size_t kind = 0; kind < std::size(kindCounts); ++kind) {
+        if (kinds & (1u << kind)) {
+            kindCounts[kind] += delta;
+        }
+    }
+}
+
+std::uint64_t ConflictDetector::bucketKey(const TimetableEntry& entry, StringInterner::Symbol resource) {
+    // Keys only narrow down the probe; every candidate is confirmed with checkConflict
+    std::uint64_t day = static_cast<int>(entry.getTimeSlot()->getDayOfWeek());
+    return day << 32 | resource;
+}
+
+void ConflictDetector::trackEntry(TimetableEntry* entry) {
+    roomBuckets[bucketKey(*entry, entry->getRoom()->getRoomSymbol())].push_back(entry);
+    lecturerBuckets[bucketKey(*entry, entry->getLecturer()->getLecturerSymbol())].push_back(entry);
+    groupBuckets[bucketKey(*entry, entry->getStudentGroup()->getGroupSymbol())].push_back(entry);
+}
+
+void ConflictDetector::addConflict(const Conflict& conflict) {
+    clashes[conflict.first].push_back(conflicts.size());
+    clashes[conflict.second].push_back(conflicts.size());
+    countKinds(conflict.kinds, 1);
+    conflicts.push_back(conflict);
+}
+
+void ConflictDetector::relink(TimetableEntry* entry, size_t from, size_t to) {
+    auto it = clashes.find(entry);
+    std::vector<size_t>& positions = it->second;
+    auto position = std::find(positions.begin(), positions.end(), from);
+    if (to != SIZE_MAX) {
+        *position = to;
+        return;
+    }
+
+    *position = positions.back();
+    positions.pop_back();
+    if (positions.empty()) {
+        clashes.erase(it);
+    }
+}
+
+void ConflictDetector::removeConflict(size_t position) {
+    const Conflict& removed = conflicts[position];
+    countKinds(removed.kinds, -1);
+    relink(removed.first, position, SIZE_MAX);
+    relink(removed.second, position, SIZE_MAX);
+
+    size_t last = conflicts.size() - 1;
+    if (position != last) {
+        conflicts[position] = conflicts[last];
+        relink(conflicts[position].first, last, position);
+        relink(conflicts[position].second, last, position);
+    }
+    conflicts.pop_back();
+}
+
+void ConflictDetector::detectConflicts(const EntryColumns& columns, unsigned int threads) {
+    std::vector<TimetableEntry*> entries = columns.getEntries();
+    std::vector<std::pair<size_t, size_t>> found = sweepConflicts(columns, threads);
+
+    // Rebuild the incrementally maintained state from scratch
+    roomBuckets.clear();
+    lecturerBuckets.clear();
+    groupBuckets.clear();
+    tracked.clear();
+    clashes.clear();
     conflicts.clear();
+    std::fill(std::begin(kindCounts), std::end(kindCounts), 0);
+    tracked.reserve(entries.size());
+
+    for (auto entry : entries) {
+        tracked.insert(entry);
+        trackEntry(entry);
+    }
+
+    // Conflict records are built from the columns rather than by following each entry's pointers
+    auto same = [&columns](EntryColumns::Key key, size_t i, size_t j) {
+        return columns.getID(key, i) == columns.getID(key, j);
+    };
+
+    conflicts.reserve(found.size());
+    for (const auto& [i, j] : found) {
+        std::uint8_t kinds = (same(EntryColumns::Key::Room, i, j) ? Conflict::RoomClash : 0) |
+                             (same(EntryColumns::Key::Lecturer, i, j) ? Conflict::LecturerClash : 0) |
+                             (same(EntryColumns::Key::Group, i, j) ? Conflict::GroupClash : 0);
+        Conflict conflict{columns.getEntry(i), columns.getEntry(j), 0, 0, kinds};
+        setOverlap(conflict, columns.getStart(i), columns.getEnd(i), columns.getStart(j), columns.getEnd(j));
+        addConflict(conflict);
+    }
+}
+
+std::vector<std::pair<size_t, size_t>> ConflictDetector::sweepConflicts(const EntryColumns& columns,
+                                                                         unsigned int threads) const {
+    const size_t rows = columns.size();
+
+    // Entries on different days can never conflict, so counting sort the rows
+    // by day and sweep each bucket on its own; weeks are told apart by mask.
+    // Erased rows are left out
+    const size_t bucketCount = 8;
+    std::vector<std::uint32_t> bucketStart(bucketCount + 1, 0);
+    for (size_t i = 0; i < rows; ++i) {
+        if (columns.getEntry(i)) {
+            ++bucketStart[columns.getDay(i) + 1];
+        }
+    }
+    for (size_t b = 0; b < bucketCount; ++b) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    std::vector<std::uint32_t> order(bucketStart[bucketCount]);
+    std::vector<std::uint32_t> next(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < rows; ++i) {
+        if (columns.getEntry(i)) {
+            order[next[columns.getDay(i)]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    // Within a day only rows sharing a room, lecturer or group can conflict, so each kind of
+    // resource is swept separately; in parallel, a kind is split further into shards of dense IDs
+    const EntryColumns::Key kinds[] = {EntryColumns::Key::Room, EntryColumns::Key::Lecturer,
+                                       EntryColumns::Key::Group};
+    size_t usedDays = 0;
+    for (size_t b = 0; b < bucketCount; ++b) {
+        usedDays += bucketStart[b] != bucketStart[b + 1];
+    }
+    bool parallel = threads > 1 && order.size() >= PARALLEL_MIN_ROWS;
+    size_t shards = 1;
+    if (parallel) {
+        size_t perShard = usedDays * std::size(kinds);
+        shards = std::max<size_t>(1, (TASKS_PER_THREAD * threads + perShard - 1) / perShard);
+    }
+
+    struct SweepTask {
+        size_t bucket;
+        size_t kind;
+        std::uint32_t shard;
+    };
+    std::vector<SweepTask> tasks;
+    for (size_t b = 0; b < bucketCount; ++b) {
+        for (size_t k = 0; bucketStart[b] != bucketStart[b + 1] && k < std::size(kinds); ++k) {
+            for (size_t shard = 0; shard < shards; ++shard) {
+                tasks.push_back({b, k, static_cast<std::uint32_t>(shard)});
+            }
+        }
+    }
+
+    // Busiest days first, so the tasks left at the end are short
+    std::stable_sort(tasks.begin(), tasks.end(), [&bucketStart](const SweepTask& a, const SweepTask& b) {
+        return bucketStart[a.bucket + 1] - bucketStart[a.bucket] > bucketStart[b.bucket + 1] - bucketStart[b.bucket];
+    });
+
+    // Each task fills its own list, so the result does not depend on which thread ran what
+    std::vector<std::vector<std::pair<size_t, size_t>>> taskFound(tasks.size());
+    auto runTask = [&](size_t t) {
+        const SweepTask& task = tasks[t];
+        std::vector<SweepItem> items;
+        for (size_t k = bucketStart[task.bucket]; k < bucketStart[task.bucket + 1]; ++k) {
+            std::uint32_t row = order[k];
+            std::uint32_t id = columns.getID(kinds[task.kind], row);
+            if (id % shards == task.shard) {
+                items.push_back({row, id, columns.getWeeks(row), columns.getStart(row), columns.getEnd(row)});
+            }
+        }
+        sweepResources(columns, items, taskFound[t]);
+    };
+
+    if (parallel) {
+        ThreadPool pool(threads);
+        pool.forEach(tasks.size(), runTask);
+    } else {
+        for (size_t t = 0; t < tasks.size(); ++t) {
+            runTask(t);
+        }
+    }
+
+    size_t total = 0;
+    for (const auto& pairs : taskFound) {
+        total += pairs.size();
+    }
+    std::vector<std::pair<size_t, size_t>> found;
+    found.reserve(total);
+    for (const auto& pairs : taskFound) {
+        found.insert(found.end(), pairs.begin(), pairs.end());
+    }
+
+    // A pair clashing on several resources is found once per resource, and
+    // sorting by index reproduces the order of the pairwise scan
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    return found;
+}
+
+void ConflictDetector::addEntry(TimetableEntry* entry) {
+    if (!entry || !tracked.insert(entry).second) {
+        return;
+    }
+
+    // Probe only the entries sharing this entry's day and a resource; checkConflict compares the week masks
+    std::vector<TimetableEntry*> found;
+    auto probe = [&](const std::unordered_map<std::uint64_t, std::vector<TimetableEntry*>>& buckets,
+                     StringInterner::Symbol resource) {
+        auto it = buckets.find(bucketKey(*entry, resource));
+        if (it == buckets.end()) {
+            return;
+        }
+
+        for (auto other : it->second) {
+            if (std::find(found.begin(), found.end(), other) == found.end() && entry->checkConflict(*other)) {
+                found.push_back(other);
+            }
+        }
+    };
+
+    probe(roomBuckets, entry->getRoom()->getRoomSymbol());
+    probe(lecturerBuckets, entry->getLecturer()->getLecturerSymbol());
+    probe(groupBuckets, entry->getStudentGroup()->getGroupSymbol());
+
+    trackEntry(entry);
+    for (auto other : found) {
+        addConflict(makeConflict(other, entry));
+    }
+}
+
+void ConflictDetector::removeEntry(TimetableEntry* entry) {
+    auto trackedIt = tracked.find(entry);
+    if (trackedIt == tracked.end()) {
+        return;
+    }
+
+    auto untrack = [entry](std::unordered_map<std::uint64_t, std::vector<TimetableEntry*>>& buckets,
+                           std::uint64_t key) {
+        auto it = buckets.find(key);
+        if (it == buckets.end()) {
+            return;
+        }
+
+        auto& bucket = it->second;
+        bucket.erase(std::remove(bucket.begin(), bucket.end(), entry), bucket.end());
+        if (bucket.empty()) {
+            buckets.erase(it);
+        }
+    };
+
+    untrack(roomBuckets, bucketKey(*entry, entry->getRoom()->getRoomSymbol()));
+    untrack(lecturerBuckets, bucketKey(*entry, entry->getLecturer()->getLecturerSymbol()));
+    untrack(groupBuckets, bucketKey(*entry, entry->getStudentGroup()->getGroupSymbol()));
+
+    // Drop only the conflicts this entry was part of
+    for (auto clashIt = clashes.find(entry); clashIt != clashes.end(); clashIt = clashes.find(entry)) {
+        removeConflict(clashIt->second.back());
+    }
+
+    tracked.erase(trackedIt);
+}
+
+bool ConflictDetector::verifyConflicts(const EntryColumns& columns) const {
+    if (columns.count() != tracked.size()) {
+        return false;
+    }
+
+    std::vector<std::pair<size_t, size_t>> found = sweepConflicts(columns, 1);
+    if (found.size() != conflicts.size()) {
+        return false;
+    }
+
+    // Each conflict must also have been recorded with the right kinds and overlap
+    for (const auto& [i, j] : found) {
+        auto it = clashes.find(columns.getEntry(i));
+        Conflict expected = makeConflict(columns.getEntry(i), columns.getEntry(j));
+        if (it == clashes.end() ||
+            std::none_of(it->second.begin(), it->second.end(),
+                         [this, &expected](size_t position) { return conflicts[position] == expected; })) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ConflictDetector::sweepResources(const EntryColumns& columns,
+                                      std::vector<SweepItem>& items,
+                                      std::vector<std::pair<size_t, size_t>>& found) const {
+    // Line up each resource's sessions in start time order
+    std::sort(items.begin(), items.end(), [](const SweepItem& a, const SweepItem& b) {
+        if (a.resource != b.resource) return a.resource < b.resource;
+        return a.start != b.start ? a.start < b.start : a.index < b.index;
+    });
+
+    std::vector<SweepItem> running;
+    for (auto first = items.begin(); first != items.end(); ) {
+        auto last = std::find_if(first, items.end(),
+                                 [first](const SweepItem& item) { return item.resource != first->resource; });
+
+        running.clear();
+        for (auto item = first; item != last; ++item) {
+            // Empty or inverted slots cannot be swept by start time, but they also
+            // rarely occur, so they are compared against the rest of the resource's sessions directly
+            if (item->start >= item->end) {
+                for (auto other = first; other != last; ++other) {
+                    if (other->index != item->index &&
+                        columns.getEntry(item->index)->checkConflict(*columns.getEntry(other->index))) {
+                        found.push_back(std::minmax(item->index, other->index));
+                    }
+                }
+                continue;
+            }
+
+            // Drop sessions that ended before this one starts; everything left overlaps it
+            running.erase(std::remove_if(running.begin(), running.end(),
+                                         [item](const SweepItem& a) { return a.end <= item->start; }),
+                          running.end());
+
+            for (const auto& a : running) {
+                if (a.weeks & item->weeks) {
+                    found.push_back(std::minmax(a.index, item->index));
+                }
+            }
+            running.push_back(*item);
+        }
+        first = last;
+    }
+}
+
+std::vector<Conflict> ConflictDetector::findConflictsPairwise(const std::vector<TimetableEntry*>& entries) const {
+    std::vector<Conflict> pairs;
 
     // Check every pair of entries for conflicts
     for (size_t i = 0; i < entries.size(); ++i) {
         for (size_t j = i + 1; j < entries.size(); ++j) {
             if (entries[i]->checkConflict(*entries[j])) {
-                conflicts.push_back({entries[i], entries[j]});
+                pairs.push_back(makeConflict(entries[i], entries[j]));
             }
         }
     }
+
+    return pairs;
+}
+
+bool ConflictDetector::checkSweep(const EntryColumns& columns, unsigned int threads) const {
+    std::vector<Conflict> expected = findConflictsPairwise(columns.getEntries());
+
+    for (unsigned int count : {1u, threads}) {
+        std::vector<std::pair<size_t, size_t>> found = sweepConflicts(columns, count);
+        if (found.size() != expected.size()) {
+            return false;
+        }
+        for (size_t k = 0; k < found.size(); ++k) {
+            if (makeConflict(columns.getEntry(found[k].first), columns.getEntry(found[k].second)) != expected[k]) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 bool ConflictDetector::hasConflicts() const {
     return !conflicts.empty();
 }
 
-std::vector<std::pair<TimetableEntry*, TimetableEntry*>> ConflictDetector::getConflicts() const {
+std::span<const Conflict> ConflictDetector::getConflicts() const {
     return conflicts;
 }
 
-std::string ConflictDetector::suggestResolution(const std::pair<TimetableEntry*, TimetableEntry*>& conflict) const {
-    TimetableEntry* entry1 = conflict.first;
-    TimetableEntry* entry2 = conflict.second;
+size_t ConflictDetector::getConflictCount(Conflict::Kind kind) const {
+    return kindCounts[std::countr_zero(static_cast<unsigned int>(kind))];
+}
 
+std::string ConflictDetector::suggestResolution(const Conflict& conflict) const {
     std::stringstream ss;
     ss << "Conflict found between:\n";
-    ss << "1. " << entry1->getEntryDetails() << "\n";
-    ss << "2. " << entry2->getEntryDetails() << "\n\n";
+    ss << "1. " << conflict.first->getEntryDetails() << "\n";
+    ss << "2. " << conflict.second->getEntryDetails() << "\n";
+    ss << "Both run from " << formatMinutes(conflict.overlapStart) << " to "
+       << formatMinutes(conflict.overlapEnd) << ".\n\n";
 
-    // Identify conflict type and suggest resolution
-    if (entry1->getRoom()->getRoomID() == entry2->getRoom()->getRoomID()) {
-        ss << "Room Double-booking: Consider using a different room for one of the sessions.\n";
+    if (conflict.kinds & Conflict::RoomClash) {
+        ss << conflictTypes[0] << ": Consider using a different room for one of the sessions.\n";
         ss << "  - Suggestion: Move session 2 to a different room.\n";
     }
-
-    if (entry1->getLecturer()->getLecturerID() == entry2->getLecturer()->getLecturerID()) {
-        ss << "Lecturer Time Conflict: Consider rescheduling one session to a different time slot.\n";
+    if (conflict.kinds & Conflict::LecturerClash) {
+        ss << conflictTypes[1] << ": Consider rescheduling one session to a different time slot.\n";
         ss << "  - Suggestion: Reschedule session 2 to a different day or time.\n";
     }
-
-    if (entry1->getStudentGroup()->getGroupID() == entry2->getStudentGroup()->getGroupID()) {
-        ss << "Student Group Time Conflict: Students cannot attend two sessions simultaneously.\n";
+    if (conflict.kinds & Conflict::GroupClash) {
+        ss << conflictTypes[2] << ": Students cannot attend two sessions simultaneously.\n";
         ss << "  - Suggestion: Reschedule one of the sessions to avoid time overlap.\n";
     }
 
     return ss.str();
-}
\ No newline at end of file
+}
@@ -0,0 +1,143 @@
+#include "../include/EntityRegistry.h"
+
+EntityRegistry::EntityRegistry() {
+}
+
+EntityRegistry::~EntityRegistry() {
+    clear();
+}
+
+Module* EntityRegistry::findModule(std::string_view code) const {
+    return modules.find(code);
+}
+
+Lecturer* EntityRegistry::findLecturer(std::string_view id) const {
+    return lecturers.find(id);
+}
+
+Room* EntityRegistry::findRoom(std::string_view id) const {
+    return rooms.find(id);
+}
+
+SessionType* EntityRegistry::findSessionType(std::string_view id) const {
+    return sessionTypes.find(id);
+}
+
+StudentGroup* EntityRegistry::findStudentGroup(std::string_view id) const {
+    return studentGroups.find(id);
+}
+
+Student* EntityRegistry::findStudent(std::string_view id) const {
+    return students.find(id);
+}
+
+Student* EntityRegistry::findStudentByNumber(std::string_view studentNumber) const {
+    Student* const* found = studentsByNumber.find(studentNumber);
+    return found ? *found : nullptr;
+}
+
+bool EntityRegistry::addModule(Module* module) {
+    return modules.add(module->getModuleCode(), module);
+}
+
+bool EntityRegistry::addLecturer(Lecturer* lecturer) {
+    return lecturers.add(lecturer->getLecturerID(), lecturer);
+}
+
+bool EntityRegistry::addRoom(Room* room) {
+    return rooms.add(room->getRoomID(), room);
+}
+
+bool EntityRegistry::addSessionType(SessionType* sessionType) {
+    return sessionTypes.add(sessionType->getTypeID(), sessionType);
+}
+
+bool EntityRegistry::addStudentGroup(StudentGroup* group) {
+    return studentGroups.add(group->getGroupID(), group);
+}
+
+bool EntityRegistry::addStudent(Student* student) {
+    if (!students.add(student->getUserID(), student)) {
+        return false;
+    }
+    // The first student registered with a number keeps it
+    studentsByNumber.insert(student->getStudentNumber(), student);
+    return true;
+}
+
+bool EntityRegistry::removeModule(std::string_view code) {
+    return modules.remove(code);
+}
+
+bool EntityRegistry::removeLecturer(std::string_view id) {
+    return lecturers.remove(id);
+}
+
+bool EntityRegistry::removeRoom(std::string_view id) {
+    return rooms.remove(id);
+}
+
+bool EntityRegistry::removeSessionType(std::string_view id) {
+    return sessionTypes.remove(id);
+}
+
+bool EntityRegistry::removeStudentGroup(std::string_view id) {
+    return studentGroups.remove(id);
+}
+
+bool EntityRegistry::removeStudent(std::string_view id) {
+    Student* student = students.find(id);
+    if (!student) {
+        return false;
+    }
+    if (findStudentByNumber(student->getStudentNumber()) == student) {
+        studentsByNumber.erase(student->getStudentNumber());
+    }
+    return students.remove(id);
+}
+
+const std::vector<Module*>& EntityRegistry::getModules() const {
+    return modules.getItems();
+}
+
+const std::vector<Lecturer*>& EntityRegistry::getLecturers() const {
+    return lecturers.getItems();
+}
+
+const std::vector<Room*>& EntityRegistry::getRooms() const {
+    return rooms.getItems();
+}
+
+const std::vector<SessionType*>& EntityRegistry::getSessionTypes() const {
+    return sessionTypes.getItems();
+}
+
+const std::vector<StudentGroup*>& EntityRegistry::getStudentGroups() const {
+    return studentGroups.getItems();
+}
+
+const std::vector<Student*>& EntityRegistry::getStudents() const {
+    return students.getItems();
+}
+
+void EntityRegistry::reserve(size_t moduleCount, size_t lecturerCount, size_t roomCount,
+                             size_t sessionTypeCount, size_t groupCount, size_t studentCount) {
+    modules.reserve(moduleCount);
+    lecturers.reserve(lecturerCount);
+    rooms.reserve(roomCount);
+    sessionTypes.reserve(sessionTypeCount);
+    studentGroups.reserve(groupCount);
+    students.reserve(studentCount);
+    studentsByNumber.reserve(studentCount);
+}
+
+void EntityRegistry::clear() {
+    // Same order the collections were always freed in; groups detach from their students
+    modules.clear();
+    rooms.clear();
+    sessionTypes.clear();
+    lecturers.clear();
+    studentGroups.clear();
+    studentsByNumber.clear();
+    students.clear();
+}
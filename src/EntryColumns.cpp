@@ -0,0 +1,233 @@
+
+#include "../include/EntryColumns.h"
+#include <algorithm>
+
+namespace {
+
+// Clears the flag of every row in a chunk whose column value differs from the wanted one
+template <typename T>
+void keepEqual(std::uint8_t* keep, const T* column, size_t count, T wanted) {
+    for (size_t i = 0; i < count; ++i) {
+        keep[i] &= static_cast<std::uint8_t>(column[i] == wanted);
+    }
+}
+
+// Clears the flag of every row in a chunk whose week mask lacks the wanted week
+void keepWeek(std::uint8_t* keep, const std::uint64_t* column, size_t count, int week) {
+    for (size_t i = 0; i < count; ++i) {
+        keep[i] &= static_cast<std::uint8_t>(column[i] >> week & 1);
+    }
+}
+
+// Clears the flag of every erased row in a chunk
+void keepLive(std::uint8_t* keep, TimetableEntry* const* entries, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        keep[i] &= static_cast<std::uint8_t>(entries[i] != nullptr);
+    }
+}
+
+}
+
+template <typename Node>
+Node& EntryColumns::own(std::shared_ptr<Node>& node, std::uint64_t epoch) {
+    if (node->epoch != epoch) {
+        // Other copies keep the old chunk
+        node = std::make_shared<Node>(*node);
+        node->epoch = epoch;
+    }
+    return *node;
+}
+
+std::uint32_t EntryColumns::intern(Key key, StringInterner::Symbol id, std::uint64_t epoch) {
+    std::vector<std::shared_ptr<IDChunk>>& table = denseIDs[static_cast<int>(key)];
+    if (id / ID_CHUNK_SYMBOLS >= table.size()) {
+        table.resize(id / ID_CHUNK_SYMBOLS + 1);
+    }
+
+    std::shared_ptr<IDChunk>& chunk = table[id / ID_CHUNK_SYMBOLS];
+    if (!chunk) {
+        chunk = std::make_shared<IDChunk>();
+        chunk->epoch = epoch;
+        std::fill(std::begin(chunk->ids), std::end(chunk->ids), UNKNOWN);
+    }
+
+    // Most entries reuse known IDs, so a shared chunk is only copied for a new one
+    std::uint32_t dense = chunk->ids[id % ID_CHUNK_SYMBOLS];
+    if (dense == UNKNOWN) {
+        dense = denseCounts[static_cast<int>(key)]++;
+        own(chunk, epoch).ids[id % ID_CHUNK_SYMBOLS] = dense;
+    }
+    return dense;
+}
+
+void EntryColumns::append(TimetableEntry* entry, std::uint64_t epoch) {
+    if (rowCount == chunks.size() * CHUNK_ROWS) {
+        chunks.push_back(std::make_shared<Chunk>());
+        chunks.back()->epoch = epoch;
+    }
+
+    const TimeSlot* slot = entry->getTimeSlot();
+    std::uint32_t ids[5] = {
+        intern(Key::Room, entry->getRoom()->getRoomSymbol(), epoch),
+        intern(Key::Lecturer, entry->getLecturer()->getLecturerSymbol(), epoch),
+        intern(Key::Group, entry->getStudentGroup()->getGroupSymbol(), epoch),
+        intern(Key::Module, entry->getModule()->getModuleSymbol(), epoch),
+        intern(Key::SessionType, entry->getSessionType()->getTypeSymbol(), epoch),
+    };
+
+    Chunk& chunk = own(chunks[rowCount / CHUNK_ROWS], epoch);
+    size_t i = rowCount % CHUNK_ROWS;
+    chunk.entries[i] = entry;
+    entry->row = rowCount;
+    chunk.weeks[i] = entry->getWeeks().getBits();
+    chunk.days[i] = static_cast<std::uint8_t>(slot->getDayOfWeek());
+    chunk.starts[i] = static_cast<std::uint16_t>(slot->getStartMinutes());
+    chunk.ends[i] = static_cast<std::uint16_t>(slot->getEndMinutes());
+    for (int key = 0; key < 5; ++key) {
+        chunk.ids[key][i] = ids[key];
+    }
+    ++rowCount;
+}
+
+void EntryColumns::erase(size_t row, std::uint64_t epoch) {
+    Chunk& chunk = own(chunks[row / CHUNK_ROWS], epoch);
+    chunk.entries[row % CHUNK_ROWS] = nullptr;
+    chunk.weeks[row % CHUNK_ROWS] = 0;
+    ++erasedCount;
+
+    // Erased rows at the end are given back, so the next append reuses them
+    while (rowCount > 0 && !getEntry(rowCount - 1)) {
+        --rowCount;
+        --erasedCount;
+    }
+    chunks.resize((rowCount + CHUNK_ROWS - 1) / CHUNK_ROWS);
+
+    // Compacting only once erased rows outnumber live ones keeps the cost per erase constant
+    if (erasedCount >= CHUNK_ROWS && erasedCount * 2 > rowCount) {
+        compact(epoch);
+    }
+}
+
+void EntryColumns::compact(std::uint64_t epoch) {
+    std::vector<std::shared_ptr<Chunk>> old;
+    old.swap(chunks);
+    size_t oldRows = rowCount;
+    rowCount = 0;
+    erasedCount = 0;
+
+    for (size_t from = 0; from < oldRows; ++from) {
+        const Chunk& source = *old[from / CHUNK_ROWS];
+        size_t i = from % CHUNK_ROWS;
+        if (!source.entries[i]) {
+            continue;
+        }
+
+        if (rowCount % CHUNK_ROWS == 0) {
+            chunks.push_back(std::make_shared<Chunk>());
+            chunks.back()->epoch = epoch;
+        }
+        Chunk& target = *chunks.back();
+        size_t j = rowCount % CHUNK_ROWS;
+        target.entries[j] = source.entries[i];
+        target.entries[j]->row = rowCount;
+        target.weeks[j] = source.weeks[i];
+        target.days[j] = source.days[i];
+        target.starts[j] = source.starts[i];
+        target.ends[j] = source.ends[i];
+        for (int key = 0; key < 5; ++key) {
+            target.ids[key][j] = source.ids[key][i];
+        }
+        ++rowCount;
+    }
+}
+
+void EntryColumns::reserve(size_t rows) {
+    chunks.reserve((rows + CHUNK_ROWS - 1) / CHUNK_ROWS);
+}
+
+void EntryColumns::clear() {
+    chunks.clear();
+    rowCount = 0;
+    erasedCount = 0;
+    for (auto& table : denseIDs) {
+        table.clear();
+    }
+    std::fill(std::begin(denseCounts), std::end(denseCounts), 0);
+}
+
+size_t EntryColumns::size() const {
+    return rowCount;
+}
+
+size_t EntryColumns::count() const {
+    return rowCount - erasedCount;
+}
+
+size_t EntryColumns::findRow(const TimetableEntry* entry) const {
+    return entry->row < rowCount && getEntry(entry->row) == entry ? entry->row : rowCount;
+}
+
+std::uint32_t EntryColumns::findID(Key key, StringInterner::Symbol id) const {
+    const std::vector<std::shared_ptr<IDChunk>>& table = denseIDs[static_cast<int>(key)];
+    if (id / ID_CHUNK_SYMBOLS >= table.size() || !table[id / ID_CHUNK_SYMBOLS]) {
+        return UNKNOWN;
+    }
+    return table[id / ID_CHUNK_SYMBOLS]->ids[id % ID_CHUNK_SYMBOLS];
+}
+
+size_t EntryColumns::idCount(Key key) const {
+    return denseCounts[static_cast<int>(key)];
+}
+
+void EntryColumns::select(const Filter& filter, std::vector<std::uint32_t>& rows) const {
+    rows.clear();
+    if (filter.week > 63 || filter.week < -1) {
+        return; // No row can hold this week
+    }
+
+    std::uint8_t keep[CHUNK_ROWS];
+    size_t count = 0;
+    for (size_t base = 0; base < rowCount; base += CHUNK_ROWS) {
+        const Chunk& chunk = *chunks[base / CHUNK_ROWS];
+        size_t length = std::min(CHUNK_ROWS, rowCount - base);
+
+        // One pass per criterion that was given, each over a single column
+        std::fill(keep, keep + length, static_cast<std::uint8_t>(1));
+        if (filter.week != -1) {
+            keepWeek(keep, chunk.weeks, length, filter.week);
+        } else if (erasedCount) {
+            keepLive(keep, chunk.entries, length);
+        }
+        if (filter.module != ANY) {
+            keepEqual(keep, chunk.ids[static_cast<int>(Key::Module)], length, filter.module);
+        }
+        if (filter.room != ANY) {
+            keepEqual(keep, chunk.ids[static_cast<int>(Key::Room)], length, filter.room);
+        }
+        if (filter.lecturer != ANY) {
+            keepEqual(keep, chunk.ids[static_cast<int>(Key::Lecturer)], length, filter.lecturer);
+        }
+        if (filter.group != ANY) {
+            keepEqual(keep, chunk.ids[static_cast<int>(Key::Group)], length, filter.group);
+        }
+
+        // Gather without branching: every row is written, only matches advance the count
+        rows.resize(count + length);
+        for (size_t i = 0; i < length; ++i) {
+            rows[count] = static_cast<std::uint32_t>(base + i);
+            count += keep[i];
+        }
+    }
+    rows.resize(count);
+}
+
+std::vector<TimetableEntry*> EntryColumns::getEntries() const {
+    std::vector<TimetableEntry*> entries;
+    entries.reserve(count());
+    for (size_t row = 0; row < rowCount; ++row) {
+        if (TimetableEntry* entry = getEntry(row)) {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
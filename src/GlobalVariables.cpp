@@ -2,10 +2,13 @@
 // GlobalVariables.cpp
 #include "../include/GlobalVariables.h"
 
-// Define the global variables
-std::vector<Module*> g_modules;
-std::vector<Student*> g_students;
-std::vector<Lecturer*> g_lecturers;
-std::vector<Room*> g_rooms;
-std::vector<SessionType*> g_sessionTypes;
-std::vector<StudentGroup*> g_studentGroups;
\ No newline at end of file
+// Define the global variables; the interner first, so it outlives every entity
+StringInterner g_strings;
+EntityRegistry g_registry;
+const std::vector<Module*>& g_modules = g_registry.getModules();
+const std::vector<Student*>& g_students = g_registry.getStudents();
+const std::vector<Lecturer*>& g_lecturers = g_registry.getLecturers();
+const std::vector<Room*>& g_rooms = g_registry.getRooms();
+const std::vector<SessionType*>& g_sessionTypes = g_registry.getSessionTypes();
+const std::vector<StudentGroup*>& g_studentGroups = g_registry.getStudentGroups();
+Journal* g_journal = nullptr;
\ No newline at end of file
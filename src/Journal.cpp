@@ -0,0 +1,615 @@
+#include "../include/Journal.h"
+#include "../include/Snapshot.h"
+#include "../include/MappedFile.h"
+#include "../include/UserManager.h"
+#include "../include/TimetableManager.h"
+#include "../include/GlobalVariables.h"
+#include <chrono>
+#include <cstring>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'N', 'T', 'U', 'J', 'R', 'N', 'L', '\0'};
+const std::uint32_t VERSION = 1;
+const size_t SEGMENT_HEADER_SIZE = sizeof(MAGIC) + sizeof(std::uint32_t);
+
+// Each record is framed as payload length, LSN, type, payload and checksum
+const size_t FRAME_HEAD_SIZE = sizeof(std::uint32_t) + sizeof(std::uint64_t) + sizeof(std::uint8_t);
+const size_t FRAME_SIZE = FRAME_HEAD_SIZE + sizeof(std::uint64_t);
+
+// FNV-1a over the LSN, type and payload of a record
+std::uint64_t checksum(std::string_view data) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        hash = (hash ^ c) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T get(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    return fsync(fileno(file)) == 0;
+#else
+    return true;
+#endif
+}
+
+bool fileExists(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::fclose(file);
+    return true;
+}
+
+// Reads the fields of a record payload, failing on the first read past the end
+class Fields {
+private:
+    std::string_view in;
+    size_t pos;
+    bool good;
+
+    template <typename T>
+    T number() {
+        if (!good || in.size() - pos < sizeof(T)) {
+            good = false;
+            return T();
+        }
+        T value = get<T>(in.data() + pos);
+        pos += sizeof(T);
+        return value;
+    }
+
+public:
+    explicit Fields(std::string_view payload) : in(payload), pos(0), good(true) {
+    }
+
+    std::uint8_t u8() { return number<std::uint8_t>(); }
+    std::uint16_t u16() { return number<std::uint16_t>(); }
+    std::int32_t i32() { return number<std::int32_t>(); }
+    std::uint64_t u64() { return number<std::uint64_t>(); }
+
+    std::string str() {
+        std::uint32_t size = number<std::uint32_t>();
+        if (!good || in.size() - pos < size) {
+            good = false;
+            return std::string();
+        }
+        std::string value(in.substr(pos, size));
+        pos += size;
+        return value;
+    }
+
+    bool ok() const { return good && pos == in.size(); }
+};
+
+}
+
+JournalRecord::JournalRecord(Type recordType) : type(recordType) {
+}
+
+JournalRecord& JournalRecord::str(std::string_view value) {
+    put(payload, static_cast<std::uint32_t>(value.size()));
+    payload += value;
+    return *this;
+}
+
+JournalRecord& JournalRecord::u8(std::uint8_t value) {
+    put(payload, value);
+    return *this;
+}
+
+JournalRecord& JournalRecord::u16(std::uint16_t value) {
+    put(payload, value);
+    return *this;
+}
+
+JournalRecord& JournalRecord::i32(std::int32_t value) {
+    put(payload, value);
+    return *this;
+}
+
+JournalRecord& JournalRecord::u64(std::uint64_t value) {
+    put(payload, value);
+    return *this;
+}
+
+JournalRecord::Type JournalRecord::getType() const {
+    return type;
+}
+
+const std::string& JournalRecord::getPayload() const {
+    return payload;
+}
+
+Journal::Journal(const std::string& journalFile, std::uint64_t threshold)
+    : filename(journalFile), file(nullptr), lastLSN(0), durableLSN(0), pendingLSN(0),
+      bytesWritten(0), compactionThreshold(threshold), writing(false), failed(false), stopping(false) {
+}
+
+Journal::~Journal() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    flushWanted.notify_all();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    waitForCompaction();
+
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool Journal::openSegment() {
+    file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    put(header, VERSION);
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size() || !syncFile(file)) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    bytesWritten = header.size();
+    failed = false;
+    return true;
+}
+
+bool Journal::open(std::uint64_t startLSN) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (file || !openSegment()) {
+        return false;
+    }
+
+    // Everything up to startLSN is in the snapshot, including any old segment
+    std::remove((filename + ".old").c_str());
+    lastLSN = durableLSN = pendingLSN = startLSN;
+    stopping = false;
+    flusher = std::thread(&Journal::flushLoop, this);
+    return true;
+}
+
+std::uint64_t Journal::append(const JournalRecord& record) {
+    const std::string& payload = record.getPayload();
+    bool wake;
+    std::uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!file || failed) {
+            return 0;
+        }
+
+        lsn = ++lastLSN;
+        size_t start = pending.size();
+        put(pending, static_cast<std::uint32_t>(payload.size()));
+        put(pending, lsn);
+        put(pending, static_cast<std::uint8_t>(record.getType()));
+        pending += payload;
+
+        // The checksum covers everything after the length
+        std::string_view covered(pending.data() + start + sizeof(std::uint32_t),
+                                 pending.size() - start - sizeof(std::uint32_t));
+        put(pending, checksum(covered));
+
+        pendingLSN = lsn;
+
+        // The first record of a batch starts the flusher's group commit window,
+        // and a full batch cuts it short
+        wake = start == 0 || pending.size() >= GROUP_COMMIT_BYTES;
+    }
+
+    if (wake) {
+        flushWanted.notify_one();
+    }
+    return lsn;
+}
+
+void Journal::writePending(std::unique_lock<std::mutex>& lock) {
+    // Only one write at a time, so records reach the file in LSN order
+    flushed.wait(lock, [this] { return !writing; });
+    if (pending.empty() || !file || failed) {
+        return;
+    }
+
+    std::string batch;
+    batch.swap(pending);
+    std::uint64_t batchLSN = pendingLSN;
+    std::FILE* target = file;
+    writing = true;
+
+    // Appends keep filling the next batch while this one is written and synced
+    lock.unlock();
+    bool written = std::fwrite(batch.data(), 1, batch.size(), target) == batch.size() && syncFile(target);
+    lock.lock();
+
+    writing = false;
+    if (written) {
+        bytesWritten += batch.size();
+        durableLSN = batchLSN;
+    } else {
+        // Later records would depend on the lost ones; the next compaction captures them all
+        failed = true;
+        pending.clear();
+    }
+    flushed.notify_all();
+}
+
+void Journal::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        flushWanted.wait(lock, [this] { return stopping || !pending.empty(); });
+
+        // Give other records a short window to join this commit
+        flushWanted.wait_for(lock, std::chrono::milliseconds(GROUP_COMMIT_MILLISECONDS),
+                             [this] { return stopping || pending.size() >= GROUP_COMMIT_BYTES; });
+        writePending(lock);
+
+        if (stopping && (pending.empty() || failed)) {
+            return;
+        }
+    }
+}
+
+bool Journal::waitDurable(std::uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(mutex);
+    flushWanted.notify_one();
+    flushed.wait(lock, [this, lsn] { return durableLSN >= lsn || failed || !file; });
+    return durableLSN >= lsn;
+}
+
+bool Journal::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    writePending(lock);
+    return pending.empty() && durableLSN == lastLSN;
+}
+
+std::uint64_t Journal::getLastLSN() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lastLSN;
+}
+
+bool Journal::needsCompaction() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return file && bytesWritten + pending.size() >= compactionThreshold;
+}
+
+bool Journal::compact(const std::string& snapshotFile, const UserManager& userManager,
+                      const TimetableManager& timetableManager) {
+    waitForCompaction();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!file) {
+        return false;
+    }
+    writePending(lock);
+
+    std::string image;
+    if (!Snapshot::encode(userManager, timetableManager, lastLSN, image)) {
+        return false;
+    }
+
+    std::string oldSegment = filename + ".old";
+    if (failed || fileExists(oldSegment)) {
+        // Records that failed to write, or that are still waiting in the old segment
+        // for an earlier compaction, are only safe once this snapshot is written
+        if (!Snapshot::write(snapshotFile, image)) {
+            return false;
+        }
+        std::remove(oldSegment.c_str());
+        std::fclose(file);
+        if (!openSegment()) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    std::fclose(file);
+    file = nullptr;
+    if (std::rename(filename.c_str(), oldSegment.c_str()) != 0 || !openSegment()) {
+        // Keep appending to the segment that is still in place
+        std::rename(oldSegment.c_str(), filename.c_str());
+        file = std::fopen(filename.c_str(), "ab");
+        failed = file == nullptr;
+        return false;
+    }
+
+    compactor = std::thread([snapshotFile, oldSegment, image = std::move(image)] {
+        if (Snapshot::write(snapshotFile, image)) {
+            std::remove(oldSegment.c_str());
+        }
+    });
+    return true;
+}
+
+void Journal::waitForCompaction() {
+    if (compactor.joinable()) {
+        compactor.join();
+    }
+}
+
+bool Journal::replaySegment(const std::string& segment, std::uint64_t afterLSN,
+                            UserManager& userManager, TimetableManager& timetableManager,
+                            std::uint64_t& lastLSN, size_t& applied) {
+    MappedFile mapped;
+    if (!mapped.open(segment)) {
+        return !fileExists(segment);
+    }
+
+    std::string_view contents = mapped.contents();
+    if (contents.size() < SEGMENT_HEADER_SIZE || std::memcmp(contents.data(), MAGIC, sizeof(MAGIC)) != 0 ||
+        get<std::uint32_t>(contents.data() + sizeof(MAGIC)) != VERSION) {
+        return false;
+    }
+
+    size_t pos = SEGMENT_HEADER_SIZE;
+    std::uint64_t previousLSN = 0;
+    while (pos < contents.size()) {
+        // A short or damaged frame is where a crash interrupted the last write
+        if (contents.size() - pos < FRAME_SIZE) {
+            return false;
+        }
+        std::uint32_t size = get<std::uint32_t>(contents.data() + pos);
+        if (contents.size() - pos - FRAME_SIZE < size) {
+            return false;
+        }
+        std::string_view covered = contents.substr(pos + sizeof(std::uint32_t), FRAME_HEAD_SIZE - sizeof(std::uint32_t) + size);
+        std::uint64_t lsn = get<std::uint64_t>(covered.data());
+        if (get<std::uint64_t>(covered.data() + covered.size()) != checksum(covered) || lsn <= previousLSN) {
+            return false;
+        }
+        pos += FRAME_SIZE + size;
+        previousLSN = lsn;
+
+        if (lsn <= afterLSN) {
+            continue;
+        }
+        if (lsn > lastLSN) {
+            lastLSN = lsn;
+        }
+
+        auto type = static_cast<JournalRecord::Type>(static_cast<std::uint8_t>(covered[sizeof(std::uint64_t)]));
+        Fields in(covered.substr(FRAME_HEAD_SIZE - sizeof(std::uint32_t)));
+        bool done = false;
+
+        switch (type) {
+            case JournalRecord::Type::CreateEntry: {
+                std::string entryID = in.str();
+                WeekSet weeks(in.u64());
+                std::string moduleCode = in.str(), lecturerID = in.str(), roomID = in.str();
+                std::string groupID = in.str(), typeID = in.str();
+                auto day = static_cast<TimeSlot::Day>(in.u8());
+                int start = in.u16(), end = in.u16();
+
+                Module* mod = g_registry.findModule(moduleCode);
+                Lecturer* lec = g_registry.findLecturer(lecturerID);
+                Room* rm = g_registry.findRoom(roomID);
+                StudentGroup* group = g_registry.findStudentGroup(groupID);
+                SessionType* session = g_registry.findSessionType(typeID);
+                if (!in.ok() || !mod || !lec || !rm || !group || !session || day > TimeSlot::Day::Sunday ||
+                    timetableManager.entriesByID.count(entryID)) {
+                    break;
+                }
+
+                TimeSlot time(day, start, end);
+                if (!timetableManager.canSchedule(weeks, mod, lec, rm, group, session, time)) {
+                    break;
+                }
+                timetableManager.storeEntry(entryID, weeks, mod, lec, rm, group, session, time);
+                timetableManager.reserveEntryID(entryID);
+                done = true;
+                break;
+            }
+            case JournalRecord::Type::DeleteEntry: {
+                std::string entryID = in.str();
+                done = in.ok() && timetableManager.deleteEntry(entryID);
+                break;
+            }
+            case JournalRecord::Type::CreateModule: {
+                std::string code = in.str(), title = in.str(), description = in.str();
+                if (in.ok() && !g_registry.findModule(code)) {
+                    g_registry.addModule(new Module(code, title, description));
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::UpdateModule: {
+                std::string code = in.str(), title = in.str(), description = in.str();
+                Module* module = g_registry.findModule(code);
+                if (in.ok() && module) {
+                    module->updateTitle(title);
+                    module->updateDescription(description);
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::DeleteModule: {
+                std::string code = in.str();
+                done = in.ok() && g_registry.removeModule(code);
+                break;
+            }
+            case JournalRecord::Type::CreateStudentGroup: {
+                std::string groupID = in.str(), name = in.str();
+                if (in.ok() && !g_registry.findStudentGroup(groupID)) {
+                    g_registry.addStudentGroup(new StudentGroup(groupID, name));
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::DeleteStudentGroup: {
+                std::string groupID = in.str();
+                done = in.ok() && g_registry.removeStudentGroup(groupID);
+                break;
+            }
+            case JournalRecord::Type::DefineSessionType: {
+                std::string typeID = in.str(), name = in.str();
+                if (in.ok() && !g_registry.findSessionType(typeID)) {
+                    g_registry.addSessionType(new SessionType(typeID, name));
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::UpdateSessionType: {
+                std::string typeID = in.str(), name = in.str();
+                SessionType* sessionType = g_registry.findSessionType(typeID);
+                if (in.ok() && sessionType) {
+                    sessionType->updateTypeName(name);
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::DeleteSessionType: {
+                std::string typeID = in.str();
+                done = in.ok() && g_registry.removeSessionType(typeID);
+                break;
+            }
+            case JournalRecord::Type::RegisterLecturer: {
+                std::string lecturerID = in.str(), name = in.str(), department = in.str();
+                if (in.ok() && !g_registry.findLecturer(lecturerID)) {
+                    g_registry.addLecturer(new Lecturer(lecturerID, name, department));
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::AssignLecturerToModule: {
+                std::string lecturerID = in.str(), code = in.str();
+                Lecturer* lecturer = g_registry.findLecturer(lecturerID);
+                Module* module = g_registry.findModule(code);
+                done = in.ok() && lecturer && module && lecturer->assignModule(module);
+                break;
+            }
+            case JournalRecord::Type::DeleteLecturer: {
+                std::string lecturerID = in.str();
+                done = in.ok() && g_registry.removeLecturer(lecturerID);
+                break;
+            }
+            case JournalRecord::Type::AddRoom: {
+                std::string roomID = in.str(), location = in.str();
+                int capacity = in.i32();
+                if (in.ok() && !g_registry.findRoom(roomID)) {
+                    g_registry.addRoom(new Room(roomID, location, capacity));
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::DeleteRoom: {
+                std::string roomID = in.str();
+                done = in.ok() && g_registry.removeRoom(roomID);
+                break;
+            }
+            case JournalRecord::Type::RegisterAdmin: {
+                std::string id = in.str(), name = in.str(), password = in.str(), department = in.str();
+                done = in.ok() && userManager.registerAdmin(id, name, password, department);
+                break;
+            }
+            case JournalRecord::Type::RegisterStudent: {
+                std::string id = in.str(), name = in.str(), password = in.str();
+                std::string number = in.str(), course = in.str();
+                done = in.ok() && userManager.registerStudent(id, name, password, number, course);
+                break;
+            }
+            case JournalRecord::Type::AdminRegisterStudent: {
+                std::string id = in.str(), name = in.str(), password = in.str();
+                std::string number = in.str(), course = in.str();
+                if (in.ok() && !userManager.getUserById(id) && !g_registry.findStudentByNumber(number)) {
+                    g_registry.addStudent(new Student(id, name, password, number, course));
+                    done = true;
+                }
+                break;
+            }
+            case JournalRecord::Type::DeleteUser: {
+                std::string id = in.str();
+                done = in.ok() && userManager.deleteUser(id);
+                break;
+            }
+            case JournalRecord::Type::AssignStudentToGroup: {
+                std::string studentID = in.str(), groupID = in.str();
+                Student* student = g_registry.findStudent(studentID);
+                StudentGroup* group = g_registry.findStudentGroup(groupID);
+                done = in.ok() && student && group && group->addStudent(student);
+                break;
+            }
+            case JournalRecord::Type::RemoveStudentFromGroup: {
+                std::string groupID = in.str(), studentID = in.str();
+                StudentGroup* group = g_registry.findStudentGroup(groupID);
+                done = in.ok() && group && group->removeStudent(studentID);
+                break;
+            }
+            case JournalRecord::Type::ChangePassword: {
+                std::string id = in.str(), password = in.str();
+                User* user = userManager.getUserById(id);
+                if (in.ok() && user) {
+                    user->password = password;
+                    done = true;
+                }
+                break;
+            }
+        }
+
+        if (done) {
+            ++applied;
+        }
+    }
+    return true;
+}
+
+size_t Journal::replay(const std::string& journalFile, std::uint64_t afterLSN,
+                       UserManager& userManager, TimetableManager& timetableManager,
+                       std::uint64_t& lastLSN, std::vector<std::string>* setAside) {
+    lastLSN = afterLSN;
+    size_t applied = 0;
+
+    // Replayed entries are published together when the batch closes
+    TimetableManager::UpdateBatch batch(timetableManager);
+
+    // Records in the main segment build on the old one, so stop if it is incomplete
+    std::vector<std::string> unfinished;
+    std::string oldSegment = journalFile + ".old";
+    if (!replaySegment(oldSegment, afterLSN, userManager, timetableManager, lastLSN, applied)) {
+        unfinished.push_back(oldSegment);
+        unfinished.push_back(journalFile);
+    } else if (!replaySegment(journalFile, afterLSN, userManager, timetableManager, lastLSN, applied)) {
+        unfinished.push_back(journalFile);
+    }
+
+    // Opening the journal truncates the main segment and deletes the old one, so keep what was not replayed
+    for (const auto& segment : unfinished) {
+        std::string aside = segment + "." + std::to_string(lastLSN) + ".damaged";
+        if (fileExists(segment) && std::rename(segment.c_str(), aside.c_str()) == 0 && setAside) {
+            setAside->push_back(aside);
+        }
+    }
+
+    if (applied > 0) {
+        timetableManager.checkForConflicts(std::thread::hardware_concurrency());
+    }
+    return applied;
+}
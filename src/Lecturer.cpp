@@ -1,23 +1,28 @@
 
 
 #include "../include/Lecturer.h"
+#include "../include/GlobalVariables.h"
 #include <algorithm>
 #include <sstream>
 
 Lecturer::Lecturer(const std::string& id, const std::string& lecturerName, const std::string& dept)
-    : lecturerID(id), name(lecturerName), department(dept) {
+    : lecturerID(g_strings.intern(id)), name(g_strings.intern(lecturerName)), department(g_strings.intern(dept)) {
 }
 
-std::string Lecturer::getLecturerID() const {
+std::string_view Lecturer::getLecturerID() const {
+    return g_strings.view(lecturerID);
+}
+
+StringInterner::Symbol Lecturer::getLecturerSymbol() const {
     return lecturerID;
 }
 
-std::string Lecturer::getName() const {
-    return name;
+std::string_view Lecturer::getName() const {
+    return g_strings.view(name);
 }
 
-std::string Lecturer::getDepartment() const {
-    return department;
+std::string_view Lecturer::getDepartment() const {
+    return g_strings.view(department);
 }
 
 const std::vector<Module*>& Lecturer::getAssignedModules() const {
@@ -31,7 +36,7 @@ bool Lecturer::assignModule(Module* module) {
 
     // Check if module already assigned
     auto it = std::find_if(assignedModules.begin(), assignedModules.end(),
-                       [module](const Module* m) { return m->getModuleCode() == module->getModuleCode(); });
+                       [module](const Module* m) { return m->getModuleSymbol() == module->getModuleSymbol(); });
 
     if (it == assignedModules.end()) {
         assignedModules.push_back(module);
@@ -41,9 +46,10 @@ bool Lecturer::assignModule(Module* module) {
     return false; // Module already assigned
 }
 
-bool Lecturer::removeModule(const std::string& moduleCode) {
+bool Lecturer::removeModule(std::string_view moduleCode) {
+    StringInterner::Symbol code = g_strings.find(moduleCode);
     auto it = std::find_if(assignedModules.begin(), assignedModules.end(),
-                       [&moduleCode](const Module* m) { return m->getModuleCode() == moduleCode; });
+                       [code](const Module* m) { return m->getModuleSymbol() == code; });
 
     if (it != assignedModules.end()) {
         assignedModules.erase(it);
@@ -53,48 +59,25 @@ bool Lecturer::removeModule(const std::string& moduleCode) {
     return false; // Module not found
 }
 
-bool Lecturer::isAvailable(const TimeSlot& timeSlot) const {
-    std::string day = timeSlot.getDay();
-
-    // If no schedule for this day, lecturer is available
-    if (schedule.find(day) == schedule.end()) {
-        return true;
-    }
-
-    // Check for time slot overlaps
-    for (const auto& occupiedSlot : schedule.at(day)) {
-        if (timeSlot.overlaps(*occupiedSlot)) {
-            return false; // Conflict found
-        }
-    }
-
-    return true; // No conflicts
+bool Lecturer::isAvailable(int week, const TimeSlot& timeSlot) const {
+    return schedule.isFree(week, timeSlot);
 }
 
-bool Lecturer::addToSchedule(TimeSlot* timeSlot) {
-    if (!timeSlot) {
-        return false;
-    }
-
-    std::string day = timeSlot->getDay();
-
-    // Check if this time slot conflicts with existing schedule
-    if (!isAvailable(*timeSlot)) {
-        return false; // Conflict exists
-    }
+bool Lecturer::filterAvailable(int week, const SlotBatch& slots, std::vector<std::uint8_t>& available) const {
+    return schedule.filterFree(week, slots, available);
+}
 
-    // Add time slot to schedule
-    if (schedule.find(day) == schedule.end()) {
-        schedule[day] = std::vector<TimeSlot*>();
-    }
+bool Lecturer::addToSchedule(int week, const TimeSlot& timeSlot) {
+    return schedule.book(week, timeSlot);
+}
 
-    schedule[day].push_back(timeSlot);
-    return true;
+void Lecturer::removeFromSchedule(int week, const TimeSlot& timeSlot) {
+    schedule.release(week, timeSlot);
 }
 
 std::string Lecturer::getDetails() const {
     std::stringstream ss;
-    ss << "Lecturer ID: " << lecturerID << ", Name: " << name << ", Department: " << department;
+    ss << "Lecturer ID: " << getLecturerID() << ", Name: " << getName() << ", Department: " << getDepartment();
     ss << ", Assigned Modules: " << assignedModules.size();
 
     return ss.str();
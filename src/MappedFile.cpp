@@ -0,0 +1,82 @@
+#include "../include/MappedFile.h"
+#include <fstream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_USE_MMAP 1
+#endif
+
+MappedFile::MappedFile() : data(nullptr), length(0), mapped(false) {
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifdef MAPPED_FILE_USE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        if (info.st_size == 0) {
+            // Nothing to map; an empty file is still opened successfully
+            ::close(fd);
+            return true;
+        }
+
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char*>(address);
+            length = static_cast<size_t>(info.st_size);
+            mapped = true;
+            ::close(fd);
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    return readIntoBuffer(filename);
+}
+
+bool MappedFile::readIntoBuffer(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = contents.str();
+    data = buffer.data();
+    length = buffer.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef MAPPED_FILE_USE_MMAP
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+    }
+#endif
+
+    data = nullptr;
+    length = 0;
+    mapped = false;
+    buffer.clear();
+}
+
+std::string_view MappedFile::contents() const {
+    return data ? std::string_view(data, length) : std::string_view();
+}
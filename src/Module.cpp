@@ -1,32 +1,42 @@
 
 
 #include "../include/Module.h"
+#include "../include/GlobalVariables.h"
 
 Module::Module(const std::string& code, const std::string& moduleTitle, const std::string& desc)
-    : moduleCode(code), title(moduleTitle), description(desc) {
+    : moduleCode(g_strings.intern(code)), title(g_strings.intern(moduleTitle)),
+      description(g_strings.intern(desc)) {
 }
 
-std::string Module::getModuleCode() const {
+std::string_view Module::getModuleCode() const {
+    return g_strings.view(moduleCode);
+}
+
+StringInterner::Symbol Module::getModuleSymbol() const {
     return moduleCode;
 }
 
-std::string Module::getTitle() const {
-    return title;
+std::string_view Module::getTitle() const {
+    return g_strings.view(title);
 }
 
-std::string Module::getDescription() const {
-    return description;
+std::string_view Module::getDescription() const {
+    return g_strings.view(description);
 }
 
 std::string Module::getDetails() const {
-    return "Module Code: " + moduleCode + ", Title: " + title +
-           (description.empty() ? "" : ", Description: " + description);
+    std::string details = "Module Code: ";
+    details.append(getModuleCode()).append(", Title: ").append(getTitle());
+    if (!getDescription().empty()) {
+        details.append(", Description: ").append(getDescription());
+    }
+    return details;
 }
 
 void Module::updateTitle(const std::string& newTitle) {
-    title = newTitle;
+    title = g_strings.intern(newTitle);
 }
 
 void Module::updateDescription(const std::string& newDescription) {
-    description = newDescription;
-}
\ No newline at end of file
+    description = g_strings.intern(newDescription);
+}
@@ -0,0 +1,291 @@
+
+#include "../include/OccupancyCalendar.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define OCCUPANCY_USE_AVX2 1
+#endif
+
+namespace {
+
+// Mask of the low n bits, for n from 0 to 64
+std::uint64_t lowBits(std::int64_t n) {
+    return n >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+}
+
+// Minutes of a bucket that fall in [start, end), one bit each
+std::uint8_t minutesIn(int bucket, int start, int end) {
+    int from = std::max(start - bucket * OccupancyCalendar::BUCKET_MINUTES, 0);
+    int to = std::min(end - bucket * OccupancyCalendar::BUCKET_MINUTES, OccupancyCalendar::BUCKET_MINUTES);
+    return from < to ? static_cast<std::uint8_t>(lowBits(to) & ~lowBits(from)) : 0;
+}
+
+// Calls f(bucket, minutes) for the one or two buckets a slot covers only in part
+template <typename F>
+void forEachEdge(const TimeSlot& timeSlot, F f) {
+    const int minutes = OccupancyCalendar::BUCKET_MINUTES;
+    int start = timeSlot.getStartMinutes(), end = timeSlot.getEndMinutes();
+    int first = start / minutes;
+    int last = (end - 1) / minutes;
+    if (start % minutes != 0 || (first == last && end % minutes != 0)) {
+        f(first, minutesIn(first, start, end));
+    }
+    if (last != first && end % minutes != 0) {
+        f(last, minutesIn(last, start, end));
+    }
+}
+
+// Clears the flag of every slot whose buckets meet a booked bucket of its day
+void overlapScalar(const std::uint64_t* weekWords, const std::int64_t* first, const std::int64_t* end,
+                   const std::int64_t* firstWord, size_t count, std::uint8_t* free) {
+    for (size_t i = 0; i < count; ++i) {
+        // Only the one or two words the slot's buckets fall in can overlap it
+        std::uint64_t hit = 0;
+        for (std::int64_t word = first[i] / 64; word * 64 < end[i]; ++word) {
+            std::int64_t from = std::max<std::int64_t>(first[i] - word * 64, 0);
+            hit |= weekWords[firstWord[i] + word] & lowBits(end[i] - word * 64) & ~lowBits(from);
+        }
+        free[i] &= static_cast<std::uint8_t>(hit == 0);
+    }
+}
+
+#ifdef OCCUPANCY_USE_AVX2
+// Same test as overlapScalar for four slots at a time. A variable shift by 64
+// or more gives zero, so (1 << n) - 1 is the mask of the low n bits for every
+// n from 0 up once negative counts are clamped to zero.
+__attribute__((target("avx2")))
+void overlapAVX2(const std::uint64_t* weekWords, const std::int64_t* first, const std::int64_t* end,
+                 const std::int64_t* firstWord, size_t count, std::uint8_t* free) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i wordBits = _mm256_set1_epi64x(64);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i from = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+        __m256i to = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(end + i));
+        __m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(firstWord + i));
+        __m256i hit = zero;
+
+        for (int word = 0; word < OccupancyCalendar::WORDS_PER_DAY; ++word) {
+            __m256i fromHere = _mm256_andnot_si256(_mm256_cmpgt_epi64(zero, from), from);
+            __m256i toHere = _mm256_andnot_si256(_mm256_cmpgt_epi64(zero, to), to);
+            __m256i below = _mm256_sub_epi64(_mm256_sllv_epi64(one, toHere), one);
+            __m256i before = _mm256_sub_epi64(_mm256_sllv_epi64(one, fromHere), one);
+            __m256i booked = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(weekWords + word), index, 8);
+            hit = _mm256_or_si256(hit, _mm256_and_si256(booked, _mm256_andnot_si256(before, below)));
+            from = _mm256_sub_epi64(from, wordBits);
+            to = _mm256_sub_epi64(to, wordBits);
+        }
+
+        int clear = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(hit, zero)));
+        for (int lane = 0; lane < 4; ++lane) {
+            free[i + lane] &= static_cast<std::uint8_t>((clear >> lane) & 1);
+        }
+    }
+
+    overlapScalar(weekWords, first + i, end + i, firstWord + i, count - i, free + i);
+}
+
+bool hasAVX2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+}
+
+SlotBatch::SlotBatch(const std::vector<TimeSlot>& slots) {
+    firstBucket.reserve(slots.size());
+    endBucket.reserve(slots.size());
+    firstWord.reserve(slots.size());
+    valid.reserve(slots.size());
+
+    for (const auto& slot : slots) {
+        // Invalid slots get an empty range on Monday and are cleared through valid instead
+        bool ok = slot.isValid();
+        int minutes = OccupancyCalendar::BUCKET_MINUTES;
+        std::int64_t first = ok ? (slot.getStartMinutes() + minutes - 1) / minutes : 0;
+        firstBucket.push_back(first);
+        endBucket.push_back(ok ? std::max<std::int64_t>(slot.getEndMinutes() / minutes, first) : 0);
+        firstWord.push_back(ok ? static_cast<int>(slot.getDayOfWeek()) * OccupancyCalendar::WORDS_PER_DAY : 0);
+        valid.push_back(ok ? 1 : 0);
+
+        if (ok && (slot.getStartMinutes() % minutes != 0 || slot.getEndMinutes() % minutes != 0)) {
+            partial.push_back(slot);
+            partialIndex.push_back(static_cast<std::uint32_t>(valid.size() - 1));
+        }
+    }
+}
+
+size_t SlotBatch::size() const {
+    return valid.size();
+}
+
+OccupancyCalendar::OccupancyCalendar() {
+}
+
+OccupancyCalendar::DayBits OccupancyCalendar::maskFor(const TimeSlot& timeSlot) {
+    DayBits mask{};
+
+    // Round inward; buckets covered in part are handled minute by minute
+    int first = (timeSlot.getStartMinutes() + BUCKET_MINUTES - 1) / BUCKET_MINUTES;
+    int last = timeSlot.getEndMinutes() / BUCKET_MINUTES;
+
+    for (int word = first / 64; word < WORDS_PER_DAY && word * 64 < last; ++word) {
+        int from = first > word * 64 ? first - word * 64 : 0;
+        int to = last < (word + 1) * 64 ? last - word * 64 : 64;
+
+        std::uint64_t bits = to == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << to) - 1;
+        bits &= ~((std::uint64_t{1} << from) - 1);
+        mask[word] = bits;
+    }
+
+    return mask;
+}
+
+std::uint8_t OccupancyCalendar::bookedMinutes(const WeekBits& week, int day, int bucket) {
+    if (!((week.days[day][bucket / 64] >> (bucket % 64)) & 1)) {
+        return 0;
+    }
+
+    // A set bucket without a partial record is booked whole
+    auto key = static_cast<std::uint16_t>(day * BUCKETS_PER_DAY + bucket);
+    auto found = std::lower_bound(week.partial.begin(), week.partial.end(), std::make_pair(key, std::uint8_t{0}));
+    return found != week.partial.end() && found->first == key ? found->second : ALL_MINUTES;
+}
+
+void OccupancyCalendar::setBookedMinutes(WeekBits& week, int day, int bucket, std::uint8_t minutes) {
+    std::uint64_t bit = std::uint64_t{1} << (bucket % 64);
+    week.days[day][bucket / 64] = minutes ? week.days[day][bucket / 64] | bit : week.days[day][bucket / 64] & ~bit;
+
+    auto key = static_cast<std::uint16_t>(day * BUCKETS_PER_DAY + bucket);
+    auto found = std::lower_bound(week.partial.begin(), week.partial.end(), std::make_pair(key, std::uint8_t{0}));
+    bool recorded = found != week.partial.end() && found->first == key;
+    if (minutes == 0 || minutes == ALL_MINUTES) {
+        if (recorded) {
+            week.partial.erase(found);
+        }
+    } else if (recorded) {
+        found->second = minutes;
+    } else {
+        week.partial.insert(found, {key, minutes});
+    }
+}
+
+bool OccupancyCalendar::edgesFree(const WeekBits& week, const TimeSlot& timeSlot) {
+    int day = static_cast<int>(timeSlot.getDayOfWeek());
+    bool free = true;
+    forEachEdge(timeSlot, [&](int bucket, std::uint8_t minutes) {
+        free = free && !(bookedMinutes(week, day, bucket) & minutes);
+    });
+    return free;
+}
+
+bool OccupancyCalendar::isFree(int week, const TimeSlot& timeSlot) const {
+    if (week < 1 || week > WEEKS || !timeSlot.isValid()) {
+        return false;
+    }
+
+    const auto& weekBits = weeks[week - 1];
+    if (!weekBits) {
+        return true;
+    }
+
+    const DayBits& bits = weekBits->days[static_cast<int>(timeSlot.getDayOfWeek())];
+    DayBits mask = maskFor(timeSlot);
+    for (int word = 0; word < WORDS_PER_DAY; ++word) {
+        if (bits[word] & mask[word]) {
+            return false;
+        }
+    }
+
+    return edgesFree(*weekBits, timeSlot);
+}
+
+bool OccupancyCalendar::filterFree(int week, const SlotBatch& slots, std::vector<std::uint8_t>& free) const {
+    size_t count = slots.size();
+    if (week < 1 || week > WEEKS) {
+        std::fill(free.begin(), free.begin() + count, static_cast<std::uint8_t>(0));
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        free[i] &= slots.valid[i];
+    }
+
+    // A week's days are contiguous, so each slot's words sit at a fixed offset from the first
+    const auto& weekBits = weeks[week - 1];
+    if (weekBits) {
+        auto kernel = overlapScalar;
+#ifdef OCCUPANCY_USE_AVX2
+        if (hasAVX2()) {
+            kernel = overlapAVX2;
+        }
+#endif
+        kernel(weekBits->days[0].data(), slots.firstBucket.data(), slots.endBucket.data(),
+               slots.firstWord.data(), count, free.data());
+
+        for (size_t i = 0; i < slots.partial.size(); ++i) {
+            std::uint8_t& flag = free[slots.partialIndex[i]];
+            if (flag && !edgesFree(*weekBits, slots.partial[i])) {
+                flag = 0;
+            }
+        }
+    }
+
+    std::uint8_t any = 0;
+    for (size_t i = 0; i < count; ++i) {
+        any |= free[i];
+    }
+    return any != 0;
+}
+
+bool OccupancyCalendar::book(int week, const TimeSlot& timeSlot) {
+    if (!isFree(week, timeSlot)) {
+        return false;
+    }
+
+    markBusy(week, timeSlot);
+    return true;
+}
+
+void OccupancyCalendar::markBusy(int week, const TimeSlot& timeSlot) {
+    if (week < 1 || week > WEEKS || !timeSlot.isValid()) {
+        return;
+    }
+
+    auto& weekBits = weeks[week - 1];
+    if (!weekBits) {
+        weekBits = std::make_unique<WeekBits>();
+    }
+
+    int day = static_cast<int>(timeSlot.getDayOfWeek());
+    DayBits& bits = weekBits->days[day];
+    DayBits mask = maskFor(timeSlot);
+    for (int word = 0; word < WORDS_PER_DAY; ++word) {
+        bits[word] |= mask[word];
+    }
+    forEachEdge(timeSlot, [&](int bucket, std::uint8_t minutes) {
+        setBookedMinutes(*weekBits, day, bucket, bookedMinutes(*weekBits, day, bucket) | minutes);
+    });
+}
+
+void OccupancyCalendar::release(int week, const TimeSlot& timeSlot) {
+    if (week < 1 || week > WEEKS || !timeSlot.isValid() || !weeks[week - 1]) {
+        return;
+    }
+
+    // Bookings never share a minute, so clearing the slot's buckets and edge minutes is exact
+    WeekBits& weekBits = *weeks[week - 1];
+    int day = static_cast<int>(timeSlot.getDayOfWeek());
+    DayBits& bits = weekBits.days[day];
+    DayBits mask = maskFor(timeSlot);
+    for (int word = 0; word < WORDS_PER_DAY; ++word) {
+        bits[word] &= ~mask[word];
+    }
+    forEachEdge(timeSlot, [&](int bucket, std::uint8_t minutes) {
+        setBookedMinutes(weekBits, day, bucket, bookedMinutes(weekBits, day, bucket) & ~minutes);
+    });
+}
@@ -0,0 +1,338 @@
+#include "../include/QueryServer.h"
+#include <charconv>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#define QUERY_SERVER_USE_SOCKETS 1
+#endif
+
+namespace {
+
+// Largest request head read before the request is refused
+const size_t MAX_REQUEST = 8192;
+
+// Seconds a client may take to send its request or accept the response
+const int CLIENT_TIMEOUT = 5;
+
+// Milliseconds the accept loop waits before checking whether it was stopped
+const int STOP_CHECK_INTERVAL = 250;
+
+#ifdef MSG_NOSIGNAL
+const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+const int SEND_FLAGS = 0;
+#endif
+
+const char* statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 431: return "Request Header Fields Too Large";
+        default: return "Internal Server Error";
+    }
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Decodes %XX escapes and, in query strings, + as a space
+bool decodeURL(std::string_view text, std::string& decoded, bool plusIsSpace) {
+    decoded.clear();
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%') {
+            int high = i + 2 < text.size() ? hexValue(text[i + 1]) : -1;
+            int low = i + 2 < text.size() ? hexValue(text[i + 2]) : -1;
+            if (high < 0 || low < 0) {
+                return false;
+            }
+            decoded += static_cast<char>(high * 16 + low);
+            i += 2;
+        } else {
+            decoded += plusIsSpace && text[i] == '+' ? ' ' : text[i];
+        }
+    }
+    return true;
+}
+
+// Looks up a parameter of a query string such as "week=3&room=R1"
+bool findParameter(std::string_view query, std::string_view name, std::string& value) {
+    while (!query.empty()) {
+        size_t end = query.find('&');
+        std::string_view pair = query.substr(0, end);
+        size_t equals = pair.find('=');
+        if (pair.substr(0, equals) == name) {
+            return decodeURL(equals == std::string_view::npos ? std::string_view() : pair.substr(equals + 1), value, true);
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        query.remove_prefix(end + 1);
+    }
+    value.clear();
+    return true;
+}
+
+// Writes a JSON string literal, escaping quotes, backslashes and control characters
+void writeString(std::string& out, std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += "\\u00";
+            out += HEX[(c >> 4) & 0xF];
+            out += HEX[c & 0xF];
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+void writeField(std::string& out, std::string_view name, std::string_view value, bool first = false) {
+    if (!first) {
+        out += ',';
+    }
+    writeString(out, name);
+    out += ':';
+    writeString(out, value);
+}
+
+std::string writeEntries(const std::vector<TimetableEntry*>& entries) {
+    std::string out = "{\"count\":" + std::to_string(entries.size()) + ",\"entries\":[";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const TimetableEntry* entry = entries[i];
+        const TimeSlot* time = entry->getTimeSlot();
+        out += i == 0 ? "{" : ",{";
+        writeField(out, "id", entry->getEntryID(), true);
+        writeField(out, "weeks", entry->getWeeks().toString());
+        writeField(out, "moduleCode", entry->getModule()->getModuleCode());
+        writeField(out, "module", entry->getModule()->getTitle());
+        writeField(out, "lecturer", entry->getLecturer()->getName());
+        writeField(out, "room", entry->getRoom()->getRoomID());
+        writeField(out, "group", entry->getStudentGroup()->getGroupID());
+        writeField(out, "sessionType", entry->getSessionType()->getTypeName());
+        writeField(out, "day", time->getDay());
+        writeField(out, "start", time->getStartTime());
+        writeField(out, "end", time->getEndTime());
+        out += '}';
+    }
+    out += "]}\n";
+    return out;
+}
+
+std::string writeError(std::string_view message) {
+    std::string out = "{\"error\":";
+    writeString(out, message);
+    out += "}\n";
+    return out;
+}
+
+}
+
+QueryServer::QueryServer(const TimetableManager& timetable, size_t threadCount)
+    : timetableManager(timetable), workers(threadCount), listenSocket(-1), stopping(false), requestsServed(0) {
+}
+
+QueryServer::~QueryServer() {
+#ifdef QUERY_SERVER_USE_SOCKETS
+    if (listenSocket >= 0) {
+        ::close(listenSocket);
+    }
+#endif
+}
+
+bool QueryServer::listen(unsigned short port) {
+#ifdef QUERY_SERVER_USE_SOCKETS
+    listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSocket < 0) {
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenSocket, SOMAXCONN) != 0) {
+        ::close(listenSocket);
+        listenSocket = -1;
+        return false;
+    }
+    return true;
+#else
+    (void)port;
+    return false;
+#endif
+}
+
+void QueryServer::serve() {
+#ifdef QUERY_SERVER_USE_SOCKETS
+    if (listenSocket < 0) {
+        return;
+    }
+
+    pollfd waiting{listenSocket, POLLIN, 0};
+    while (!stopping.load()) {
+        // Interrupted or timed out polls just check for a stop again
+        if (poll(&waiting, 1, STOP_CHECK_INTERVAL) <= 0) {
+            continue;
+        }
+
+        int client = ::accept(listenSocket, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+
+        // A client that stalls must not hold a worker for long
+        timeval timeout{CLIENT_TIMEOUT, 0};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        workers.submit([this, client] { handleConnection(client); });
+    }
+
+    workers.wait();
+#endif
+}
+
+void QueryServer::stop() {
+    stopping.store(true);
+}
+
+size_t QueryServer::getRequestsServed() const {
+    return requestsServed.load();
+}
+
+void QueryServer::handleConnection(int socket) {
+#ifdef QUERY_SERVER_USE_SOCKETS
+    // Read up to the blank line ending the request head; a body is not expected
+    std::string request;
+    char buffer[2048];
+    size_t headEnd = std::string::npos;
+    while (headEnd == std::string::npos && request.size() < MAX_REQUEST) {
+        ssize_t received = ::recv(socket, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            ::close(socket);
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+        headEnd = request.find("\r\n\r\n");
+    }
+
+    int status = 431;
+    std::string body;
+    if (headEnd == std::string::npos) {
+        body = writeError("request too large");
+    } else {
+        // Request line: METHOD TARGET VERSION
+        std::string_view line(request.data(), request.find("\r\n"));
+        size_t methodEnd = line.find(' ');
+        size_t targetEnd = methodEnd == std::string_view::npos ? methodEnd : line.find(' ', methodEnd + 1);
+        if (targetEnd == std::string_view::npos) {
+            status = 400;
+            body = writeError("malformed request line");
+        } else {
+            body = answer(line.substr(0, methodEnd), line.substr(methodEnd + 1, targetEnd - methodEnd - 1), status);
+        }
+    }
+
+    std::string response = "HTTP/1.1 " + std::to_string(status) + " " + statusText(status) + "\r\n" +
+                           "Content-Type: application/json\r\n" +
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                           "Connection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = ::send(socket, response.data() + sent, response.size() - sent, SEND_FLAGS);
+        if (written <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+
+    ::close(socket);
+    requestsServed.fetch_add(1);
+#else
+    (void)socket;
+#endif
+}
+
+std::string QueryServer::answer(std::string_view method, std::string_view target, int& status) const {
+    if (method != "GET") {
+        status = 405;
+        return writeError("only GET is supported");
+    }
+
+    size_t queryStart = target.find('?');
+    std::string_view path = target.substr(0, queryStart);
+    std::string_view query = queryStart == std::string_view::npos ? std::string_view() : target.substr(queryStart + 1);
+
+    std::string weekText;
+    int week = -1;
+    if (!findParameter(query, "week", weekText)) {
+        status = 400;
+        return writeError("malformed query string");
+    }
+    if (!weekText.empty()) {
+        auto result = std::from_chars(weekText.data(), weekText.data() + weekText.size(), week);
+        if (result.ec != std::errc() || result.ptr != weekText.data() + weekText.size() ||
+            week < WeekSet::FIRST_WEEK || week > WeekSet::LAST_WEEK) {
+            status = 400;
+            return writeError("week must be a number from 1 to 53");
+        }
+    }
+
+    // Entries are formatted while the version is held, so a concurrent delete cannot free them
+    std::shared_ptr<const TimetableVersion> version = timetableManager.getPublishedVersion();
+
+    if (path == "/search") {
+        std::string moduleCode, roomID, lecturerID;
+        if (!findParameter(query, "module", moduleCode) || !findParameter(query, "room", roomID) ||
+            !findParameter(query, "lecturer", lecturerID)) {
+            status = 400;
+            return writeError("malformed query string");
+        }
+        status = 200;
+        return writeEntries(version->searchTimetable(week, moduleCode, roomID, lecturerID));
+    }
+
+    // The remaining routes are /{kind}/{id}
+    size_t slash = path.find('/', 1);
+    std::string id;
+    if (slash == std::string_view::npos || slash + 1 == path.size() || !decodeURL(path.substr(slash + 1), id, false)) {
+        status = 404;
+        return writeError("unknown route");
+    }
+
+    std::string_view kind = path.substr(0, slash);
+    status = 200;
+    if (kind == "/group") {
+        return writeEntries(version->getTimetableForGroup(id, week));
+    }
+    if (kind == "/lecturer") {
+        return writeEntries(version->getTimetableForLecturer(id, week));
+    }
+    if (kind == "/room") {
+        return writeEntries(version->getTimetableForRoom(id, week));
+    }
+
+    status = 404;
+    return writeError("unknown route");
+}
@@ -1,16 +1,21 @@
 #include "../include/Room.h"
+#include "../include/GlobalVariables.h"
 #include <sstream>
 
 Room::Room(const std::string& id, const std::string& loc, int cap)
-    : roomID(id), location(loc), capacity(cap) {
+    : roomID(g_strings.intern(id)), location(g_strings.intern(loc)), capacity(cap) {
 }
 
-std::string Room::getRoomID() const {
+std::string_view Room::getRoomID() const {
+    return g_strings.view(roomID);
+}
+
+StringInterner::Symbol Room::getRoomSymbol() const {
     return roomID;
 }
 
-std::string Room::getLocation() const {
-    return location;
+std::string_view Room::getLocation() const {
+    return g_strings.view(location);
 }
 
 int Room::getCapacity() const {
@@ -19,45 +24,22 @@ int Room::getCapacity() const {
 
 std::string Room::getDetails() const {
     std::stringstream ss;
-    ss << "Room ID: " << roomID << ", Location: " << location << ", Capacity: " << capacity;
+    ss << "Room ID: " << getRoomID() << ", Location: " << getLocation() << ", Capacity: " << capacity;
     return ss.str();
 }
 
-bool Room::isAvailable(const TimeSlot& timeSlot) const {
-    std::string day = timeSlot.getDay();
-
-    // If no schedule for this day, room is available
-    if (schedule.find(day) == schedule.end()) {
-        return true;
-    }
-
-    // Check for time slot overlaps
-    for (const auto& occupiedSlot : schedule.at(day)) {
-        if (timeSlot.overlaps(*occupiedSlot)) {
-            return false; // Conflict found
-        }
-    }
-
-    return true; // No conflicts
+bool Room::isAvailable(int week, const TimeSlot& timeSlot) const {
+    return schedule.isFree(week, timeSlot);
 }
 
-bool Room::bookTimeSlot(TimeSlot* timeSlot) {
-    if (!timeSlot) {
-        return false;
-    }
-
-    std::string day = timeSlot->getDay();
-
-    // Check if this time slot conflicts with existing bookings
-    if (!isAvailable(*timeSlot)) {
-        return false; // Conflict exists
-    }
+bool Room::filterAvailable(int week, const SlotBatch& slots, std::vector<std::uint8_t>& available) const {
+    return schedule.filterFree(week, slots, available);
+}
 
-    // Add time slot to schedule
-    if (schedule.find(day) == schedule.end()) {
-        schedule[day] = std::vector<TimeSlot*>();
-    }
+bool Room::bookTimeSlot(int week, const TimeSlot& timeSlot) {
+    return schedule.book(week, timeSlot);
+}
 
-    schedule[day].push_back(timeSlot);
-    return true;
+void Room::releaseTimeSlot(int week, const TimeSlot& timeSlot) {
+    schedule.release(week, timeSlot);
 }
\ No newline at end of file
@@ -1,21 +1,28 @@
 #include "../include/SessionType.h"
+#include "../include/GlobalVariables.h"
 
 SessionType::SessionType(const std::string& id, const std::string& name)
-    : typeID(id), typeName(name) {
+    : typeID(g_strings.intern(id)), typeName(g_strings.intern(name)) {
 }
 
-std::string SessionType::getTypeID() const {
+std::string_view SessionType::getTypeID() const {
+    return g_strings.view(typeID);
+}
+
+StringInterner::Symbol SessionType::getTypeSymbol() const {
     return typeID;
 }
 
-std::string SessionType::getTypeName() const {
-    return typeName;
+std::string_view SessionType::getTypeName() const {
+    return g_strings.view(typeName);
 }
 
 std::string SessionType::getSessionDetails() const {
-    return "Session Type ID: " + typeID + ", Name: " + typeName;
+    std::string details = "Session Type ID: ";
+    details.append(getTypeID()).append(", Name: ").append(getTypeName());
+    return details;
 }
 
 void SessionType::updateTypeName(const std::string& newName) {
-    typeName = newName;
+    typeName = g_strings.intern(newName);
 }
\ No newline at end of file
@@ -0,0 +1,569 @@
+#include "../include/Snapshot.h"
+#include "../include/MappedFile.h"
+#include "../include/GlobalVariables.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = {'N', 'T', 'U', 'S', 'N', 'A', 'P', '\0'};
+const std::uint32_t BYTE_ORDER_TAG = 0x01020304;
+
+// Fixed-size header in front of the payload
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t payloadSize;
+    std::uint64_t checksum;
+    std::uint64_t lsn;
+};
+
+// FNV-1a over 64-bit words, then any trailing bytes
+std::uint64_t checksum(std::string_view data) {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    const std::uint64_t prime = 0x100000001b3ULL;
+
+    size_t words = data.size() / 8;
+    for (size_t i = 0; i < words; ++i) {
+        std::uint64_t word;
+        std::memcpy(&word, data.data() + i * 8, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (size_t i = words * 8; i < data.size(); ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return hash;
+}
+
+// Appends fixed-width values and length-prefixed strings to a buffer
+class Writer {
+private:
+    std::string out;
+
+    template <typename T>
+    void put(T value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+public:
+    void u8(std::uint8_t value) { put(value); }
+    void u16(std::uint16_t value) { put(value); }
+    void u32(std::uint32_t value) { put(value); }
+    void i32(std::int32_t value) { put(value); }
+    void u64(std::uint64_t value) { put(value); }
+
+    void str(std::string_view value) {
+        u32(static_cast<std::uint32_t>(value.size()));
+        out += value;
+    }
+
+    const std::string& data() const { return out; }
+};
+
+// Reads values back, failing on the first read past the end
+class Reader {
+private:
+    std::string_view in;
+    size_t pos;
+    bool good;
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (!good || in.size() - pos < sizeof(T)) {
+            good = false;
+            return value;
+        }
+        std::memcpy(&value, in.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+public:
+    explicit Reader(std::string_view data) : in(data), pos(0), good(true) {
+    }
+
+    std::uint8_t u8() { return get<std::uint8_t>(); }
+    std::uint16_t u16() { return get<std::uint16_t>(); }
+    std::uint32_t u32() { return get<std::uint32_t>(); }
+    std::int32_t i32() { return get<std::int32_t>(); }
+    std::uint64_t u64() { return get<std::uint64_t>(); }
+
+    std::string str() {
+        std::uint32_t size = u32();
+        if (!good || in.size() - pos < size) {
+            good = false;
+            return std::string();
+        }
+        std::string value(in.substr(pos, size));
+        pos += size;
+        return value;
+    }
+
+    // Reads an index and checks it refers to one of count items
+    std::uint32_t index(size_t count) {
+        std::uint32_t value = u32();
+        if (value >= count) {
+            good = false;
+        }
+        return value;
+    }
+
+    // Reads a table size, rejecting sizes that could not fit in the remaining data
+    std::uint32_t count(size_t minimumItemSize) {
+        std::uint32_t value = u32();
+        if (good && value > (in.size() - pos) / minimumItemSize) {
+            good = false;
+        }
+        return good ? value : 0;
+    }
+
+    bool ok() const { return good; }
+    bool atEnd() const { return pos == in.size(); }
+};
+
+template <typename T>
+std::unordered_map<const T*, std::uint32_t> indexOf(const std::vector<T*>& items) {
+    std::unordered_map<const T*, std::uint32_t> indices;
+    indices.reserve(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        indices.emplace(items[i], static_cast<std::uint32_t>(i));
+    }
+    return indices;
+}
+
+// Checks no two items share an ID, since the registry indexes them by ID
+template <typename T, typename KeyOf>
+bool uniqueIDs(const std::vector<T*>& items, KeyOf keyOf) {
+    FlatIndex<bool> seen;
+    seen.reserve(items.size());
+    for (auto item : items) {
+        if (!seen.insert(keyOf(item), true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Saved timetable entry, with references as table indices
+struct EntryRecord {
+    std::string entryID;
+    WeekSet weeks;
+    std::uint32_t module, lecturer, room, group, sessionType;
+    TimeSlot::Day day;
+    int start, end;
+};
+
+// Everything decoded from a snapshot; owns the objects until they are handed over
+struct Decoded {
+    std::vector<Module*> modules;
+    std::vector<SessionType*> sessionTypes;
+    std::vector<Room*> rooms;
+    std::vector<Lecturer*> lecturers;
+    std::vector<Student*> students;
+    std::vector<Admin*> admins;
+    std::vector<StudentGroup*> groups;
+    std::vector<EntryRecord> entries;
+    int nextEntryNumber = 1;
+    bool handedOver = false;
+
+    ~Decoded() {
+        if (handedOver) {
+            return;
+        }
+
+        // Groups first, so students are never left pointing at a deleted group
+        for (auto group : groups) delete group;
+        for (auto student : students) delete student;
+        for (auto admin : admins) delete admin;
+        for (auto lecturer : lecturers) delete lecturer;
+        for (auto room : rooms) delete room;
+        for (auto sessionType : sessionTypes) delete sessionType;
+        for (auto module : modules) delete module;
+    }
+};
+
+bool decode(Reader& in, Decoded& out) {
+    // Smallest possible encodings, used to reject impossible table sizes early
+    const size_t STRING = 4, INDEX = 4;
+
+    for (std::uint32_t i = 0, n = in.count(3 * STRING); i < n && in.ok(); ++i) {
+        std::string code = in.str(), title = in.str(), description = in.str();
+        out.modules.push_back(new Module(code, title, description));
+    }
+
+    for (std::uint32_t i = 0, n = in.count(2 * STRING); i < n && in.ok(); ++i) {
+        std::string id = in.str(), name = in.str();
+        out.sessionTypes.push_back(new SessionType(id, name));
+    }
+
+    for (std::uint32_t i = 0, n = in.count(2 * STRING + 4); i < n && in.ok(); ++i) {
+        std::string id = in.str(), location = in.str();
+        std::int32_t capacity = in.i32();
+        out.rooms.push_back(new Room(id, location, capacity));
+    }
+
+    for (std::uint32_t i = 0, n = in.count(3 * STRING + 4); i < n && in.ok(); ++i) {
+        std::string id = in.str(), name = in.str(), department = in.str();
+        Lecturer* lecturer = new Lecturer(id, name, department);
+        out.lecturers.push_back(lecturer);
+        for (std::uint32_t m = 0, count = in.count(INDEX); m < count && in.ok(); ++m) {
+            std::uint32_t module = in.index(out.modules.size());
+            if (in.ok()) {
+                lecturer->assignModule(out.modules[module]);
+            }
+        }
+    }
+
+    for (std::uint32_t i = 0, n = in.count(5 * STRING); i < n && in.ok(); ++i) {
+        std::string id = in.str(), name = in.str(), password = in.str();
+        std::string number = in.str(), course = in.str();
+        out.students.push_back(new Student(id, name, password, number, course));
+    }
+
+    for (std::uint32_t i = 0, n = in.count(4 * STRING); i < n && in.ok(); ++i) {
+        std::string id = in.str(), name = in.str(), password = in.str(), department = in.str();
+        out.admins.push_back(new Admin(id, name, password, department));
+    }
+
+    // Students and admins share one ID space, since users log in by ID
+    std::vector<User*> users(out.students.begin(), out.students.end());
+    users.insert(users.end(), out.admins.begin(), out.admins.end());
+    if (!uniqueIDs(users, [](User* u) { return u->getUserID(); }) ||
+        !uniqueIDs(out.students, [](Student* s) { return s->getStudentNumber(); })) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0, n = in.count(2 * STRING + 4); i < n && in.ok(); ++i) {
+        std::string id = in.str(), name = in.str();
+        StudentGroup* group = new StudentGroup(id, name);
+        out.groups.push_back(group);
+        for (std::uint32_t s = 0, count = in.count(INDEX); s < count && in.ok(); ++s) {
+            std::uint32_t student = in.index(out.students.size());
+            if (in.ok()) {
+                group->addStudent(out.students[student]);
+            }
+        }
+    }
+
+    if (!uniqueIDs(out.modules, [](Module* m) { return m->getModuleCode(); }) ||
+        !uniqueIDs(out.sessionTypes, [](SessionType* t) { return t->getTypeID(); }) ||
+        !uniqueIDs(out.rooms, [](Room* r) { return r->getRoomID(); }) ||
+        !uniqueIDs(out.lecturers, [](Lecturer* l) { return l->getLecturerID(); }) ||
+        !uniqueIDs(out.groups, [](StudentGroup* g) { return g->getGroupID(); })) {
+        return false;
+    }
+
+    out.nextEntryNumber = in.i32();
+    for (std::uint32_t i = 0, n = in.count(STRING + 8 + 5 * INDEX + 5); i < n && in.ok(); ++i) {
+        EntryRecord entry;
+        entry.entryID = in.str();
+        entry.weeks = WeekSet(in.u64());
+        entry.module = in.index(out.modules.size());
+        entry.lecturer = in.index(out.lecturers.size());
+        entry.room = in.index(out.rooms.size());
+        entry.group = in.index(out.groups.size());
+        entry.sessionType = in.index(out.sessionTypes.size());
+        entry.day = static_cast<TimeSlot::Day>(in.u8());
+        entry.start = in.u16();
+        entry.end = in.u16();
+        if (entry.day > TimeSlot::Day::Sunday) {
+            return false;
+        }
+        out.entries.push_back(std::move(entry));
+    }
+
+    return in.ok() && in.atEnd();
+}
+
+}
+
+bool Snapshot::encode(const UserManager& userManager, const TimetableManager& timetableManager,
+                      std::uint64_t lsn, std::string& image) {
+    auto moduleIndex = indexOf(g_modules);
+    auto sessionTypeIndex = indexOf(g_sessionTypes);
+    auto roomIndex = indexOf(g_rooms);
+    auto lecturerIndex = indexOf(g_lecturers);
+    auto groupIndex = indexOf(g_studentGroups);
+
+    const std::vector<Student*>& students = g_students;
+    auto studentIndex = indexOf(students);
+    const std::vector<Admin*>& admins = userManager.admins;
+
+    Writer out;
+
+    out.u32(static_cast<std::uint32_t>(g_modules.size()));
+    for (auto module : g_modules) {
+        out.str(module->getModuleCode());
+        out.str(module->getTitle());
+        out.str(module->getDescription());
+    }
+
+    out.u32(static_cast<std::uint32_t>(g_sessionTypes.size()));
+    for (auto sessionType : g_sessionTypes) {
+        out.str(sessionType->getTypeID());
+        out.str(sessionType->getTypeName());
+    }
+
+    out.u32(static_cast<std::uint32_t>(g_rooms.size()));
+    for (auto room : g_rooms) {
+        out.str(room->getRoomID());
+        out.str(room->getLocation());
+        out.i32(room->getCapacity());
+    }
+
+    out.u32(static_cast<std::uint32_t>(g_lecturers.size()));
+    for (auto lecturer : g_lecturers) {
+        out.str(lecturer->getLecturerID());
+        out.str(lecturer->getName());
+        out.str(lecturer->getDepartment());
+
+        const auto& modules = lecturer->getAssignedModules();
+        out.u32(static_cast<std::uint32_t>(modules.size()));
+        for (auto module : modules) {
+            auto it = moduleIndex.find(module);
+            if (it == moduleIndex.end()) {
+                return false;
+            }
+            out.u32(it->second);
+        }
+    }
+
+    out.u32(static_cast<std::uint32_t>(students.size()));
+    for (size_t i = 0; i < students.size(); ++i) {
+        out.str(students[i]->getUserID());
+        out.str(students[i]->getName());
+        out.str(students[i]->password);
+        out.str(students[i]->getStudentNumber());
+        out.str(students[i]->getCourse());
+    }
+
+    out.u32(static_cast<std::uint32_t>(admins.size()));
+    for (auto admin : admins) {
+        out.str(admin->getUserID());
+        out.str(admin->getName());
+        out.str(admin->password);
+        out.str(admin->getDepartment());
+    }
+
+    out.u32(static_cast<std::uint32_t>(g_studentGroups.size()));
+    for (auto group : g_studentGroups) {
+        out.str(group->getGroupID());
+        out.str(group->getGroupName());
+
+        // Members that are not registered students cannot be restored
+        std::vector<std::uint32_t> members;
+        for (auto student : group->getStudents()) {
+            auto it = studentIndex.find(student);
+            if (it != studentIndex.end()) {
+                members.push_back(it->second);
+            }
+        }
+        out.u32(static_cast<std::uint32_t>(members.size()));
+        for (auto member : members) {
+            out.u32(member);
+        }
+    }
+
+    out.i32(timetableManager.nextEntryNumber);
+    const auto& entries = timetableManager.getAllEntries();
+    out.u32(static_cast<std::uint32_t>(entries.size()));
+    for (auto entry : entries) {
+        auto module = moduleIndex.find(entry->getModule());
+        auto lecturer = lecturerIndex.find(entry->getLecturer());
+        auto room = roomIndex.find(entry->getRoom());
+        auto group = groupIndex.find(entry->getStudentGroup());
+        auto sessionType = sessionTypeIndex.find(entry->getSessionType());
+        if (module == moduleIndex.end() || lecturer == lecturerIndex.end() || room == roomIndex.end() ||
+            group == groupIndex.end() || sessionType == sessionTypeIndex.end()) {
+            return false;
+        }
+
+        const TimeSlot* slot = entry->getTimeSlot();
+        out.str(entry->getEntryID());
+        out.u64(entry->getWeeks().getBits());
+        out.u32(module->second);
+        out.u32(lecturer->second);
+        out.u32(room->second);
+        out.u32(group->second);
+        out.u32(sessionType->second);
+        out.u8(static_cast<std::uint8_t>(slot->getDayOfWeek()));
+        out.u16(static_cast<std::uint16_t>(slot->getStartMinutes()));
+        out.u16(static_cast<std::uint16_t>(slot->getEndMinutes()));
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_TAG;
+    header.payloadSize = out.data().size();
+    header.checksum = checksum(out.data());
+    header.lsn = lsn;
+
+    image.clear();
+    image.reserve(sizeof(header) + out.data().size());
+    image.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    image += out.data();
+    return true;
+}
+
+bool Snapshot::write(const std::string& filename, const std::string& image) {
+    // Write beside the target and swap it in once complete
+    std::string temporary = filename + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+
+    bool written = std::fwrite(image.data(), 1, image.size(), file) == image.size() &&
+                   std::fflush(file) == 0;
+#if defined(__unix__) || defined(__APPLE__)
+    written = written && fsync(fileno(file)) == 0;
+#endif
+    written = std::fclose(file) == 0 && written;
+
+    if (!written) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        // Some platforms will not rename over an existing file
+        std::remove(filename.c_str());
+        if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Snapshot::save(const std::string& filename, const UserManager& userManager,
+                    const TimetableManager& timetableManager, std::uint64_t lsn) {
+    std::string image;
+    return encode(userManager, timetableManager, lsn, image) && write(filename, image);
+}
+
+Snapshot::LoadResult Snapshot::load(const std::string& filename, UserManager& userManager,
+                                    TimetableManager& timetableManager, std::uint64_t* lsn) {
+    if (!userManager.admins.empty() || !timetableManager.getAllEntries().empty() ||
+        !g_modules.empty() || !g_sessionTypes.empty() || !g_rooms.empty() ||
+        !g_lecturers.empty() || !g_students.empty() || !g_studentGroups.empty()) {
+        return LoadResult::NotEmpty;
+    }
+
+    // Only a file that is not there at all counts as missing; one that cannot be opened is invalid
+    std::error_code error;
+    if (!std::filesystem::exists(filename, error) && !error) {
+        return LoadResult::Missing;
+    }
+
+    MappedFile file;
+    if (!file.open(filename)) {
+        return LoadResult::Invalid;
+    }
+
+    std::string_view contents = file.contents();
+    Header header{};
+    if (contents.size() < sizeof(header)) {
+        return LoadResult::Invalid;
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        return LoadResult::Invalid;
+    }
+
+    std::string_view payload = contents.substr(sizeof(header));
+    if (header.byteOrder != BYTE_ORDER_TAG || header.payloadSize != payload.size() ||
+        header.checksum != checksum(payload)) {
+        return LoadResult::Invalid;
+    }
+
+    Decoded decoded;
+    Reader in(payload);
+    if (!decode(in, decoded)) {
+        return LoadResult::Invalid;
+    }
+
+    // Every entry must be storable, or none is: check IDs and book the decoded lecturers and
+    // rooms as storing would, then release the bookings again so storing can make them
+    std::unordered_set<std::string_view> entryIDs;
+    size_t booked = 0;
+    for (const auto& record : decoded.entries) {
+        Lecturer* lec = decoded.lecturers[record.lecturer];
+        Room* rm = decoded.rooms[record.room];
+        TimeSlot time(record.day, record.start, record.end);
+        if (!entryIDs.insert(record.entryID).second ||
+            !timetableManager.canSchedule(record.weeks, decoded.modules[record.module], lec, rm,
+                                          decoded.groups[record.group], decoded.sessionTypes[record.sessionType],
+                                          time)) {
+            break;
+        }
+        for (int week = record.weeks.first(); week; week = record.weeks.next(week)) {
+            lec->addToSchedule(week, time);
+            rm->bookTimeSlot(week, time);
+        }
+        ++booked;
+    }
+    for (size_t i = 0; i < booked; ++i) {
+        const EntryRecord& record = decoded.entries[i];
+        TimeSlot time(record.day, record.start, record.end);
+        for (int week = record.weeks.first(); week; week = record.weeks.next(week)) {
+            decoded.lecturers[record.lecturer]->removeFromSchedule(week, time);
+            decoded.rooms[record.room]->releaseTimeSlot(week, time);
+        }
+    }
+    if (booked != decoded.entries.size()) {
+        return LoadResult::Invalid;
+    }
+
+    // Hand the decoded objects over to their owners
+    decoded.handedOver = true;
+    g_registry.reserve(decoded.modules.size(), decoded.lecturers.size(), decoded.rooms.size(),
+                       decoded.sessionTypes.size(), decoded.groups.size(), decoded.students.size());
+    for (auto module : decoded.modules) g_registry.addModule(module);
+    for (auto sessionType : decoded.sessionTypes) g_registry.addSessionType(sessionType);
+    for (auto room : decoded.rooms) g_registry.addRoom(room);
+    for (auto lecturer : decoded.lecturers) g_registry.addLecturer(lecturer);
+    for (auto group : decoded.groups) g_registry.addStudentGroup(group);
+
+    for (auto student : decoded.students) g_registry.addStudent(student);
+    userManager.admins.reserve(decoded.admins.size());
+    userManager.adminsByID.reserve(decoded.admins.size());
+    for (auto admin : decoded.admins) userManager.addAdmin(admin);
+
+    timetableManager.working.columns.reserve(decoded.entries.size());
+    timetableManager.entriesByID.reserve(decoded.entries.size());
+    for (const auto& record : decoded.entries) {
+        Module* mod = decoded.modules[record.module];
+        Lecturer* lec = decoded.lecturers[record.lecturer];
+        Room* rm = decoded.rooms[record.room];
+        StudentGroup* group = decoded.groups[record.group];
+        SessionType* session = decoded.sessionTypes[record.sessionType];
+        TimeSlot time(record.day, record.start, record.end);
+        timetableManager.storeEntry(record.entryID, record.weeks, mod, lec, rm, group, session, time);
+    }
+
+    if (decoded.nextEntryNumber > timetableManager.nextEntryNumber) {
+        timetableManager.nextEntryNumber = decoded.nextEntryNumber;
+    }
+    timetableManager.checkForConflicts(std::thread::hardware_concurrency());
+    timetableManager.changed();
+
+    if (lsn) {
+        *lsn = header.lsn;
+    }
+    return LoadResult::Loaded;
+}
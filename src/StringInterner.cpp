@@ -0,0 +1,126 @@
+#include "../include/StringInterner.h"
+#include <bit>
+#include <functional>
+
+StringInterner::Table::Table(size_t capacity) : slots(capacity) {
+    for (auto& slot : slots) {
+        slot.store(NONE, std::memory_order_relaxed);
+    }
+}
+
+StringInterner::StringInterner() : count(0) {
+    tables.push_back(std::make_unique<Table>(64));
+    table.store(tables.back().get(), std::memory_order_release);
+}
+
+StringInterner::~StringInterner() {
+    for (auto& segment : segments) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
+
+size_t StringInterner::hashOf(std::string_view text) {
+    return std::hash<std::string_view>()(text);
+}
+
+int StringInterner::segmentOf(Symbol symbol, size_t& offset) {
+    // Counting from the first segment's size, each segment starts at the next power of two
+    size_t position = static_cast<size_t>(symbol) + (size_t(1) << FIRST_SEGMENT_BITS);
+    int segment = std::bit_width(position) - 1 - FIRST_SEGMENT_BITS;
+    offset = position - (size_t(1) << (segment + FIRST_SEGMENT_BITS));
+    return segment;
+}
+
+const StringInterner::Record& StringInterner::record(Symbol symbol) const {
+    size_t offset;
+    int segment = segmentOf(symbol, offset);
+    return segments[segment].load(std::memory_order_acquire)[offset];
+}
+
+StringInterner::Symbol StringInterner::lookup(const Table& in, std::string_view text, size_t hash,
+                                              size_t& slot) const {
+    size_t mask = in.slots.size() - 1;
+    for (slot = hash & mask; ; slot = (slot + 1) & mask) {
+        // The acquire load pairs with the release store in intern, so the symbol's record is complete
+        Symbol symbol = in.slots[slot].load(std::memory_order_acquire);
+        if (symbol == NONE) {
+            return NONE;
+        }
+
+        const Record& found = record(symbol);
+        if (found.hash == hash && found.text == text) {
+            return symbol;
+        }
+    }
+}
+
+void StringInterner::grow() {
+    const Table& old = *tables.back();
+    auto bigger = std::make_unique<Table>(old.slots.size() * 2);
+
+    // Every text is distinct, so each symbol goes in the first empty slot of its run
+    size_t mask = bigger->slots.size() - 1;
+    size_t symbols = count.load(std::memory_order_relaxed);
+    for (Symbol symbol = 0; symbol < symbols; ++symbol) {
+        size_t i = record(symbol).hash & mask;
+        while (bigger->slots[i].load(std::memory_order_relaxed) != NONE) {
+            i = (i + 1) & mask;
+        }
+        bigger->slots[i].store(symbol, std::memory_order_relaxed);
+    }
+
+    // Readers pick up the new table from now on; ones still probing the old table finish there
+    table.store(bigger.get(), std::memory_order_release);
+    tables.push_back(std::move(bigger));
+}
+
+StringInterner::Symbol StringInterner::intern(std::string_view text) {
+    // Most strings are already interned, and finding them needs no lock
+    Symbol symbol = find(text);
+    if (symbol != NONE) {
+        return symbol;
+    }
+
+    std::lock_guard<std::mutex> lock(internMutex);
+    size_t hash = hashOf(text);
+    Table& current = *tables.back();
+    size_t slot;
+    symbol = lookup(current, text, hash, slot);
+    if (symbol != NONE) {
+        return symbol; // Interned by another thread meanwhile
+    }
+
+    // Write the record before the table slot, so readers finding the symbol also find its text
+    symbol = static_cast<Symbol>(count.load(std::memory_order_relaxed));
+    size_t offset;
+    int segment = segmentOf(symbol, offset);
+    Record* records = segments[segment].load(std::memory_order_relaxed);
+    if (!records) {
+        records = new Record[size_t(1) << (segment + FIRST_SEGMENT_BITS)];
+        segments[segment].store(records, std::memory_order_release);
+    }
+    Record& added = records[offset];
+    added.hash = hash;
+    added.text = text;
+    current.slots[slot].store(symbol, std::memory_order_release);
+    count.store(symbol + 1, std::memory_order_release);
+
+    // Keep the table at most half full so probe runs stay short
+    if ((symbol + 1) * size_t(2) > current.slots.size()) {
+        grow();
+    }
+    return symbol;
+}
+
+StringInterner::Symbol StringInterner::find(std::string_view text) const {
+    size_t slot;
+    return lookup(*table.load(std::memory_order_acquire), text, hashOf(text), slot);
+}
+
+std::string_view StringInterner::view(Symbol symbol) const {
+    return record(symbol).text;
+}
+
+size_t StringInterner::size() const {
+    return count.load(std::memory_order_acquire);
+}
@@ -3,54 +3,67 @@
 #include "../include/TimetableManager.h"
 #include "../include/TimetableEntry.h"
 #include "../include/StudentGroup.h"
+#include "../include/GlobalVariables.h"
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
-// Global collections
-extern std::vector<StudentGroup*> g_studentGroups;
-
 Student::Student(const std::string& id, const std::string& name, const std::string& pwd,
                  const std::string& studentNum, const std::string& courseName)
-    : User(id, name, pwd), studentNumber(studentNum), course(courseName) {
+    : User(id, name, pwd), studentNumber(g_strings.intern(studentNum)), course(g_strings.intern(courseName)) {
+}
+
+Student::~Student() {
+    // Copy first, since each removal updates groups
+    std::vector<StudentGroup*> memberOf = groups;
+    for (auto group : memberOf) {
+        group->removeStudent(getUserID());
+    }
+}
+
+void Student::joinGroup(StudentGroup* group) {
+    groups.push_back(group);
+}
+
+void Student::leaveGroup(StudentGroup* group) {
+    groups.erase(std::remove(groups.begin(), groups.end(), group), groups.end());
 }
 
 std::string Student::getUserDetails() const {
-    return User::getUserDetails() + ", Student Number: " + studentNumber + ", Course: " + course;
+    std::string details = User::getUserDetails();
+    details.append(", Student Number: ").append(getStudentNumber()).append(", Course: ").append(getCourse());
+    return details;
 }
 
-std::string Student::getStudentNumber() const {
-    return studentNumber;
+std::string_view Student::getStudentNumber() const {
+    return g_strings.view(studentNumber);
 }
 
-std::string Student::getCourse() const {
-    return course;
+std::string_view Student::getCourse() const {
+    return g_strings.view(course);
+}
+
+const std::vector<StudentGroup*>& Student::getGroups() const {
+    return groups;
 }
 
 std::vector<TimetableEntry*> Student::viewTimetable(const TimetableManager& timetableManager, int week) const {
     std::vector<TimetableEntry*> studentTimetable;
 
-    // Find all groups this student belongs to
-    std::vector<std::string> groupIDs;
-    for (const auto& group : g_studentGroups) {
-        if (group->hasStudent(getUserID())) {
-            groupIDs.push_back(group->getGroupID());
-        }
-    }
-
     // If student isn't in any groups, return empty timetable
-    if (groupIDs.empty()) {
+    if (groups.empty()) {
         std::cout << "Student does not belong to any groups." << std::endl;
         return studentTimetable;
     }
 
     // Collect timetable entries for all groups the student belongs to
-    for (const auto& groupID : groupIDs) {
-        auto groupTimetable = timetableManager.getTimetableForGroup(groupID, week);
+    for (const auto& group : groups) {
+        auto groupTimetable = timetableManager.getTimetableForGroup(group->getGroupID(), week);
         studentTimetable.insert(studentTimetable.end(), groupTimetable.begin(), groupTimetable.end());
     }
 
     // Display timetable in console
-    std::cout << "\n==== Timetable for " << getName() << " (" << studentNumber << ") ====\n";
+    std::cout << "\n==== Timetable for " << getName() << " (" << getStudentNumber() << ") ====\n";
     if (week != -1) {
         std::cout << "Week: " << week << "\n";
     }
@@ -74,13 +87,17 @@ std::vector<TimetableEntry*> Student::searchTimetable(const TimetableManager& ti
     // Get the student's timetable first
     auto studentTimetable = viewTimetable(timetableManager, -1); // Get all weeks
 
-    // Apply filters
+    // Apply filters, comparing symbols; text that was never interned matches no entry
+    StringInterner::Symbol module = g_strings.find(moduleCode);
+    StringInterner::Symbol room = g_strings.find(roomID);
+    StringInterner::Symbol lecturer = g_strings.find(lecturerID);
+
     std::vector<TimetableEntry*> filteredTimetable;
     for (const auto& entry : studentTimetable) {
-        bool matchesWeek = (week == -1) || (entry->getWeekNumber() == week);
-        bool matchesModule = moduleCode.empty() || (entry->getModule()->getModuleCode() == moduleCode);
-        bool matchesRoom = roomID.empty() || (entry->getRoom()->getRoomID() == roomID);
-        bool matchesLecturer = lecturerID.empty() || (entry->getLecturer()->getLecturerID() == lecturerID);
+        bool matchesWeek = (week == -1) || entry->getWeeks().contains(week);
+        bool matchesModule = moduleCode.empty() || (entry->getModule()->getModuleSymbol() == module);
+        bool matchesRoom = roomID.empty() || (entry->getRoom()->getRoomSymbol() == room);
+        bool matchesLecturer = lecturerID.empty() || (entry->getLecturer()->getLecturerSymbol() == lecturer);
 
         if (matchesWeek && matchesModule && matchesRoom && matchesLecturer) {
             filteredTimetable.push_back(entry);
@@ -122,17 +139,23 @@ bool Student::exportTimetable(const TimetableManager& timetableManager, const st
     // Write CSV header
     file << "Week,Day,Start Time,End Time,Module,Module Code,Lecturer,Room,Session Type\n";
 
-    // Write timetable entries
+    // Write timetable entries, one row for each week an entry runs in
     for (const auto& entry : studentTimetable) {
-        file << entry->getWeekNumber() << ","
-             << entry->getTimeSlot()->getDay() << ","
-             << entry->getTimeSlot()->getStartTime() << ","
-             << entry->getTimeSlot()->getEndTime() << ","
-             << entry->getModule()->getTitle() << ","
-             << entry->getModule()->getModuleCode() << ","
-             << entry->getLecturer()->getName() << ","
-             << entry->getRoom()->getRoomID() << ","
-             << entry->getSessionType()->getTypeName() << "\n";
+        const WeekSet& weeks = entry->getWeeks();
+        for (int w = weeks.first(); w; w = weeks.next(w)) {
+            if (week != -1 && w != week) {
+                continue;
+            }
+            file << w << ","
+                 << entry->getTimeSlot()->getDay() << ","
+                 << entry->getTimeSlot()->getStartTime() << ","
+                 << entry->getTimeSlot()->getEndTime() << ","
+                 << entry->getModule()->getTitle() << ","
+                 << entry->getModule()->getModuleCode() << ","
+                 << entry->getLecturer()->getName() << ","
+                 << entry->getRoom()->getRoomID() << ","
+                 << entry->getSessionType()->getTypeName() << "\n";
+        }
     }
 
     file.close();
@@ -1,18 +1,29 @@
 
 #include "../include/StudentGroup.h"
+#include "../include/GlobalVariables.h"
 #include <algorithm>
 #include <sstream>
 
 StudentGroup::StudentGroup(const std::string& id, const std::string& name)
-    : groupID(id), groupName(name) {
+    : groupID(g_strings.intern(id)), groupName(g_strings.intern(name)) {
 }
 
-std::string StudentGroup::getGroupID() const {
+StudentGroup::~StudentGroup() {
+    for (auto student : students) {
+        student->leaveGroup(this);
+    }
+}
+
+std::string_view StudentGroup::getGroupID() const {
+    return g_strings.view(groupID);
+}
+
+StringInterner::Symbol StudentGroup::getGroupSymbol() const {
     return groupID;
 }
 
-std::string StudentGroup::getGroupName() const {
-    return groupName;
+std::string_view StudentGroup::getGroupName() const {
+    return g_strings.view(groupName);
 }
 
 const std::vector<Student*>& StudentGroup::getStudents() const {
@@ -24,19 +35,24 @@ bool StudentGroup::addStudent(Student* student) {
         return false;
     }
 
-    if (!hasStudent(student->getUserID())) {
+    // The student's own group list is much shorter than the group's student list
+    const auto& memberOf = student->getGroups();
+    if (std::find(memberOf.begin(), memberOf.end(), this) == memberOf.end()) {
         students.push_back(student);
+        student->joinGroup(this);
         return true;
     }
 
     return false; // Student already in group
 }
 
-bool StudentGroup::removeStudent(const std::string& studentID) {
+bool StudentGroup::removeStudent(std::string_view studentID) {
+    StringInterner::Symbol id = g_strings.find(studentID);
     auto it = std::find_if(students.begin(), students.end(),
-                           [&studentID](const Student* s) { return s->getUserID() == studentID; });
+                           [id](const Student* s) { return s->getUserSymbol() == id; });
 
     if (it != students.end()) {
+        (*it)->leaveGroup(this);
         students.erase(it);
         return true;
     }
@@ -44,14 +60,15 @@ bool StudentGroup::removeStudent(const std::string& studentID) {
     return false; // Student not found
 }
 
-bool StudentGroup::hasStudent(const std::string& studentID) const {
+bool StudentGroup::hasStudent(std::string_view studentID) const {
+    StringInterner::Symbol id = g_strings.find(studentID);
     return std::any_of(students.begin(), students.end(),
-                      [&studentID](const Student* s) { return s->getUserID() == studentID; });
+                      [id](const Student* s) { return s->getUserSymbol() == id; });
 }
 
 std::string StudentGroup::getDetails() const {
     std::stringstream ss;
-    ss << "Group ID: " << groupID << ", Name: " << groupName;
+    ss << "Group ID: " << getGroupID() << ", Name: " << getGroupName();
     ss << ", Students: " << students.size();
 
     return ss.str();
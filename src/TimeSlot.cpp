@@ -1,48 +1,135 @@
 
 #include "../include/TimeSlot.h"
+#include <cctype>
 #include <sstream>
 
+namespace {
+const char* const DAY_NAMES[] = {
+    "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"
+};
+}
+
 TimeSlot::TimeSlot(const std::string& d, const std::string& start, const std::string& end)
-    : day(d), startTime(start), endTime(end) {
+    : TimeSlot(parseDay(d), timeToMinutes(start), timeToMinutes(end)) {
+}
+
+TimeSlot::TimeSlot(Day d, int startMinutes, int endMinutes)
+    : day(d), start(0), end(0) {
+    // Anything that cannot be placed in the week is stored as an empty slot
+    // at the start of the week, which never overlaps anything
+    if (day == Day::Invalid || startMinutes < 0 || startMinutes > MINUTES_PER_DAY ||
+        endMinutes < 0 || endMinutes > MINUTES_PER_DAY) {
+        day = Day::Invalid;
+        return;
+    }
+
+    int dayOffset = static_cast<int>(day) * MINUTES_PER_DAY;
+    start = static_cast<std::uint16_t>(dayOffset + startMinutes);
+    end = static_cast<std::uint16_t>(dayOffset + endMinutes);
+}
+
+TimeSlot::Day TimeSlot::parseDay(std::string_view name) {
+    auto lower = [](char c) {
+        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    };
+
+    for (int i = 0; i < 7; ++i) {
+        std::string_view dayName = DAY_NAMES[i];
+
+        // Accept the full name or its three-letter abbreviation
+        if (name.size() != dayName.size() && name.size() != 3) {
+            continue;
+        }
+
+        bool matches = true;
+        for (size_t c = 0; c < name.size() && matches; ++c) {
+            matches = lower(name[c]) == lower(dayName[c]);
+        }
+        if (matches) {
+            return static_cast<Day>(i);
+        }
+    }
+
+    return Day::Invalid;
+}
+
+std::string TimeSlot::dayName(Day d) {
+    return d == Day::Invalid ? "Invalid" : DAY_NAMES[static_cast<int>(d)];
 }
 
 std::string TimeSlot::getDay() const {
+    return dayName(day);
+}
+
+TimeSlot::Day TimeSlot::getDayOfWeek() const {
     return day;
 }
 
 std::string TimeSlot::getStartTime() const {
-    return startTime;
+    return minutesToTime(getStartMinutes());
 }
 
 std::string TimeSlot::getEndTime() const {
-    return endTime;
+    return minutesToTime(getEndMinutes());
+}
+
+int TimeSlot::getStartMinutes() const {
+    return day == Day::Invalid ? 0 : start - static_cast<int>(day) * MINUTES_PER_DAY;
+}
+
+int TimeSlot::getEndMinutes() const {
+    return day == Day::Invalid ? 0 : end - static_cast<int>(day) * MINUTES_PER_DAY;
+}
+
+bool TimeSlot::isValid() const {
+    return day != Day::Invalid && start < end;
 }
 
 std::string TimeSlot::getTimeSlotDetails() const {
     std::stringstream ss;
-    ss << day << " " << startTime << " - " << endTime;
+    ss << getDay() << " " << getStartTime() << " - " << getEndTime();
     return ss.str();
 }
 
-int TimeSlot::timeToMinutes(const std::string& timeStr) const {
-    // Assuming format is "HH:MM"
-    int hours = std::stoi(timeStr.substr(0, 2));
-    int minutes = std::stoi(timeStr.substr(3, 2));
-    return hours * 60 + minutes;
-}
+int TimeSlot::timeToMinutes(std::string_view timeStr) {
+    // Accepts "HH:MM" or "H:MM"
+    size_t colon = timeStr.find(':');
+    if (colon == std::string_view::npos || colon == 0 || colon > 2 || timeStr.size() != colon + 3) {
+        return -1;
+    }
 
-bool TimeSlot::overlaps(const TimeSlot& other) const {
-    // Different days cannot overlap
-    if (day != other.day) {
-        return false;
+    int hours = 0;
+    for (size_t i = 0; i < colon; ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(timeStr[i]))) {
+            return -1;
+        }
+        hours = hours * 10 + (timeStr[i] - '0');
+    }
+
+    if (!std::isdigit(static_cast<unsigned char>(timeStr[colon + 1])) ||
+        !std::isdigit(static_cast<unsigned char>(timeStr[colon + 2]))) {
+        return -1;
+    }
+    int minutes = (timeStr[colon + 1] - '0') * 10 + (timeStr[colon + 2] - '0');
+
+    if (minutes > 59 || hours > 24 || (hours == 24 && minutes != 0)) {
+        return -1;
     }
 
-    // Convert times to minutes for easier comparison
-    int thisStart = timeToMinutes(startTime);
-    int thisEnd = timeToMinutes(endTime);
-    int otherStart = timeToMinutes(other.startTime);
-    int otherEnd = timeToMinutes(other.endTime);
+    return hours * 60 + minutes;
+}
 
-    // Check for overlap
-    return (thisStart < otherEnd && thisEnd > otherStart);
-}
\ No newline at end of file
+std::string TimeSlot::minutesToTime(int minutes) {
+    std::string result = "00:00";
+    result[0] = static_cast<char>('0' + minutes / 600);
+    result[1] = static_cast<char>('0' + minutes / 60 % 10);
+    result[3] = static_cast<char>('0' + minutes % 60 / 10);
+    result[4] = static_cast<char>('0' + minutes % 10);
+    return result;
+}
+
+bool TimeSlot::overlaps(const TimeSlot& other) const {
+    // Slots on different days occupy disjoint minute-of-week ranges, so
+    // no separate day comparison is needed
+    return start < other.end && end > other.start;
+}
@@ -2,31 +2,18 @@
 #include "../include/TimetableEntry.h"
 #include <sstream>
 
-TimetableEntry::TimetableEntry(const std::string& id, int week, Module* mod, Lecturer* lec,
-                             Room* rm, StudentGroup* group, SessionType* session, TimeSlot* time)
-    : entryID(id), weekNumber(week), module(mod), lecturer(lec),
-      room(rm), studentGroup(group), sessionType(session), timeSlot(time) {
-
-    // Register the time slot with the lecturer and room
-    if (lecturer && timeSlot) {
-        lecturer->addToSchedule(timeSlot);
-    }
-
-    if (room && timeSlot) {
-        room->bookTimeSlot(timeSlot);
-    }
-}
-
-TimetableEntry::~TimetableEntry() {
-    delete timeSlot;
+TimetableEntry::TimetableEntry(const std::string& id, const WeekSet& runWeeks, Module* mod, Lecturer* lec,
+                             Room* rm, StudentGroup* group, SessionType* session, const TimeSlot& time)
+    : entryID(id), weeks(runWeeks), module(mod), lecturer(lec),
+      room(rm), studentGroup(group), sessionType(session), timeSlot(time), row(0) {
 }
 
-std::string TimetableEntry::getEntryID() const {
+std::string_view TimetableEntry::getEntryID() const {
     return entryID;
 }
 
-int TimetableEntry::getWeekNumber() const {
-    return weekNumber;
+const WeekSet& TimetableEntry::getWeeks() const {
+    return weeks;
 }
 
 Module* TimetableEntry::getModule() const {
@@ -49,48 +36,48 @@ SessionType* TimetableEntry::getSessionType() const {
     return sessionType;
 }
 
-TimeSlot* TimetableEntry::getTimeSlot() const {
-    return timeSlot;
+const TimeSlot* TimetableEntry::getTimeSlot() const {
+    return &timeSlot;
 }
 
 std::string TimetableEntry::getEntryDetails() const {
     std::stringstream ss;
     ss << "Entry ID: " << entryID
-       << ", Week: " << weekNumber
+       << (weeks.count() == 1 ? ", Week: " : ", Weeks: ") << weeks.toString()
        << ", Module: " << module->getTitle()
        << " (" << module->getModuleCode() << ")"
        << ", Lecturer: " << lecturer->getName()
        << ", Room: " << room->getRoomID()
        << ", Group: " << studentGroup->getGroupName()
        << ", Session: " << sessionType->getTypeName()
-       << ", Time: " << timeSlot->getTimeSlotDetails();
+       << ", Time: " << timeSlot.getTimeSlotDetails();
 
     return ss.str();
 }
 
 bool TimetableEntry::checkConflict(const TimetableEntry& other) const {
-    // Check if entries are for the same week
-    if (weekNumber != other.weekNumber) {
+    // Check if entries share a week
+    if (!weeks.intersects(other.weeks)) {
         return false;
     }
 
     // Check if there's a time conflict
-    if (!timeSlot->overlaps(*other.timeSlot)) {
+    if (!timeSlot.overlaps(other.timeSlot)) {
         return false;
     }
 
     // Check if the same room is booked
-    if (room->getRoomID() == other.room->getRoomID()) {
+    if (room->getRoomSymbol() == other.room->getRoomSymbol()) {
         return true;
     }
 
     // Check if the same lecturer is booked
-    if (lecturer->getLecturerID() == other.lecturer->getLecturerID()) {
+    if (lecturer->getLecturerSymbol() == other.lecturer->getLecturerSymbol()) {
         return true;
     }
 
     // Check if the same student group is booked
-    if (studentGroup->getGroupID() == other.studentGroup->getGroupID()) {
+    if (studentGroup->getGroupSymbol() == other.studentGroup->getGroupSymbol()) {
         return true;
     }
 
@@ -0,0 +1,668 @@
+#include "../include/TimetableGenerator.h"
+#include "../include/OccupancyCalendar.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Cost of leaving a session unplaced, far above any soft cost
+const long long UNPLACED_PENALTY = 1000000;
+
+// Cost of two sessions of the same demand falling on the same day
+const long long SAME_DAY_PENALTY = 120;
+
+// Sessions are preferred inside these hours
+const int CORE_START = 10 * 60;
+const int CORE_END = 17 * 60;
+
+// One weekly session expanded from a demand
+struct Session {
+    int demand;
+    int lecturer;
+    int group;
+    int duration;
+    int capacity;
+    int firstWeek;
+    int lastWeek;
+    std::vector<int> rooms; // Rooms large enough, smallest first
+};
+
+// Where a session is held; room is -1 while unplaced
+struct Placement {
+    int room = -1;
+    int day = 0;
+    int start = 0;
+};
+
+// Read-only description of what has to be placed, shared by every search
+struct Problem {
+    const GenerationOptions* options;
+    std::vector<Room*> rooms;
+    std::vector<Lecturer*> lecturers;
+    std::vector<StudentGroup*> groups;
+    std::vector<Session> sessions;
+    std::vector<std::pair<int, int>> demandSessions; // First session index and count per demand
+    std::vector<OccupancyCalendar> groupBusy;        // Existing entries of each group
+};
+
+// Mutable search state: placements plus the bookings they make
+class Search {
+private:
+    const Problem& problem;
+    std::vector<Placement> placements;
+    std::vector<OccupancyCalendar> roomCalendars;
+    std::vector<OccupancyCalendar> lecturerCalendars;
+    std::vector<OccupancyCalendar> groupCalendars;
+    std::vector<std::vector<int>> roomSessions;
+    std::vector<std::vector<int>> lecturerSessions;
+    std::vector<std::vector<int>> groupSessions;
+    std::vector<int> unplaced;
+    std::vector<int> unplacedPosition;      // Index in unplaced, or -1 while placed
+    std::vector<int> touched;               // Sessions moved since the last best solution
+    std::vector<char> isTouched;
+    long long softTotal;
+    std::mt19937 rng;
+
+    TimeSlot slotFor(int s, int day, int start) const {
+        return TimeSlot(problem.options->days[day], start, start + problem.sessions[s].duration);
+    }
+
+    int startCount(int s) const {
+        const GenerationOptions& opts = *problem.options;
+        int span = opts.dayEndMinutes - opts.dayStartMinutes - problem.sessions[s].duration;
+        return span < 0 ? 0 : span / opts.startStepMinutes + 1;
+    }
+
+    // Free of bookings made outside this search
+    bool externallyFree(int s, int room, int day, int start) const {
+        const Session& session = problem.sessions[s];
+        TimeSlot slot = slotFor(s, day, start);
+        for (int week = session.firstWeek; week <= session.lastWeek; ++week) {
+            if (!problem.rooms[room]->isAvailable(week, slot) ||
+                !problem.lecturers[session.lecturer]->isAvailable(week, slot) ||
+                !problem.groupBusy[session.group].isFree(week, slot)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Lecturer and student group are free, whichever room is used
+    bool peopleFree(int s, int day, int start) const {
+        const Session& session = problem.sessions[s];
+        TimeSlot slot = slotFor(s, day, start);
+        for (int week = session.firstWeek; week <= session.lastWeek; ++week) {
+            if (!lecturerCalendars[session.lecturer].isFree(week, slot) ||
+                !groupCalendars[session.group].isFree(week, slot) ||
+                !problem.lecturers[session.lecturer]->isAvailable(week, slot) ||
+                !problem.groupBusy[session.group].isFree(week, slot)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool roomFree(int s, int room, int day, int start) const {
+        const Session& session = problem.sessions[s];
+        TimeSlot slot = slotFor(s, day, start);
+        for (int week = session.firstWeek; week <= session.lastWeek; ++week) {
+            if (!roomCalendars[room].isFree(week, slot) || !problem.rooms[room]->isAvailable(week, slot)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool feasible(int s, int room, int day, int start) const {
+        return peopleFree(s, day, start) && roomFree(s, room, day, start);
+    }
+
+    // Cost of holding s at a placement, counting same-day siblings other than s
+    long long softCost(int s, int room, int day, int start) const {
+        const Session& session = problem.sessions[s];
+        long long cost = problem.rooms[room]->getCapacity() - session.capacity;
+
+        int end = start + session.duration;
+        cost += std::max(0, CORE_START - start) + std::max(0, end - CORE_END);
+
+        auto siblings = problem.demandSessions[session.demand];
+        for (int other = siblings.first; other < siblings.first + siblings.second; ++other) {
+            if (other != s && placements[other].room != -1 && placements[other].day == day) {
+                cost += SAME_DAY_PENALTY;
+            }
+        }
+        return cost;
+    }
+
+    // Placed sessions that stop s from being held at a placement
+    std::vector<int> blockers(int s, int room, int day, int start) const {
+        const Session& session = problem.sessions[s];
+        int end = start + session.duration;
+        std::vector<int> found;
+
+        auto scan = [&](const std::vector<int>& candidates) {
+            for (int other : candidates) {
+                const Session& o = problem.sessions[other];
+                const Placement& p = placements[other];
+                if (other == s || p.day != day || p.start >= end || p.start + o.duration <= start ||
+                    o.lastWeek < session.firstWeek || o.firstWeek > session.lastWeek) {
+                    continue;
+                }
+                if (std::find(found.begin(), found.end(), other) == found.end()) {
+                    found.push_back(other);
+                }
+            }
+        };
+
+        scan(roomSessions[room]);
+        scan(lecturerSessions[session.lecturer]);
+        scan(groupSessions[session.group]);
+        return found;
+    }
+
+    void addUnplaced(int s) {
+        unplacedPosition[s] = static_cast<int>(unplaced.size());
+        unplaced.push_back(s);
+    }
+
+    void removeUnplaced(int s) {
+        int position = unplacedPosition[s];
+        if (position == -1) {
+            return;
+        }
+
+        unplaced[position] = unplaced.back();
+        unplacedPosition[unplaced[position]] = position;
+        unplaced.pop_back();
+        unplacedPosition[s] = -1;
+    }
+
+    void touch(int s) {
+        if (!isTouched[s]) {
+            isTouched[s] = 1;
+            touched.push_back(s);
+        }
+    }
+
+    void clearTouched() {
+        for (int s : touched) {
+            isTouched[s] = 0;
+        }
+        touched.clear();
+    }
+
+public:
+    Search(const Problem& p, unsigned int seed)
+        : problem(p), placements(p.sessions.size()),
+          roomCalendars(p.rooms.size()), lecturerCalendars(p.lecturers.size()),
+          groupCalendars(p.groups.size()), roomSessions(p.rooms.size()),
+          lecturerSessions(p.lecturers.size()), groupSessions(p.groups.size()),
+          unplacedPosition(p.sessions.size(), -1), isTouched(p.sessions.size(), 0),
+          softTotal(0), rng(seed) {
+    }
+
+    void place(int s, const Placement& at) {
+        const Session& session = problem.sessions[s];
+        TimeSlot slot = slotFor(s, at.day, at.start);
+        for (int week = session.firstWeek; week <= session.lastWeek; ++week) {
+            roomCalendars[at.room].book(week, slot);
+            lecturerCalendars[session.lecturer].book(week, slot);
+            groupCalendars[session.group].book(week, slot);
+        }
+
+        softTotal += softCost(s, at.room, at.day, at.start);
+        placements[s] = at;
+        roomSessions[at.room].push_back(s);
+        lecturerSessions[session.lecturer].push_back(s);
+        groupSessions[session.group].push_back(s);
+        removeUnplaced(s);
+        touch(s);
+    }
+
+    void unplace(int s) {
+        const Session& session = problem.sessions[s];
+        Placement at = placements[s];
+        TimeSlot slot = slotFor(s, at.day, at.start);
+        for (int week = session.firstWeek; week <= session.lastWeek; ++week) {
+            roomCalendars[at.room].release(week, slot);
+            lecturerCalendars[session.lecturer].release(week, slot);
+            groupCalendars[session.group].release(week, slot);
+        }
+
+        softTotal -= softCost(s, at.room, at.day, at.start);
+        auto drop = [s](std::vector<int>& list) {
+            list.erase(std::find(list.begin(), list.end(), s));
+        };
+        drop(roomSessions[at.room]);
+        drop(lecturerSessions[session.lecturer]);
+        drop(groupSessions[session.group]);
+        placements[s] = Placement();
+        addUnplaced(s);
+        touch(s);
+    }
+
+    // Finds the cheapest feasible placement, taking the smallest free room at each time.
+    // Every (day, start) is checked at once, one batch per week and calendar.
+    bool bestPlacement(int s, Placement& best) const {
+        const Session& session = problem.sessions[s];
+        int starts = startCount(s);
+
+        std::vector<Placement> candidates;
+        std::vector<TimeSlot> slots;
+        for (size_t day = 0; day < problem.options->days.size(); ++day) {
+            for (int i = 0; i < starts; ++i) {
+                int start = problem.options->dayStartMinutes + i * problem.options->startStepMinutes;
+                candidates.push_back({-1, static_cast<int>(day), start});
+                slots.push_back(slotFor(s, static_cast<int>(day), start));
+            }
+        }
+        SlotBatch batch(slots);
+
+        // Times when the lecturer and student group are free
+        std::vector<std::uint8_t> waiting(slots.size(), 1);
+        bool any = !slots.empty();
+        for (int week = session.firstWeek; any && week <= session.lastWeek; ++week) {
+            any = lecturerCalendars[session.lecturer].filterFree(week, batch, waiting) &&
+                  groupCalendars[session.group].filterFree(week, batch, waiting) &&
+                  problem.lecturers[session.lecturer]->filterAvailable(week, batch, waiting) &&
+                  problem.groupBusy[session.group].filterFree(week, batch, waiting);
+        }
+        size_t remaining = std::count(waiting.begin(), waiting.end(), 1);
+
+        // Each of those times takes the first room, smallest first, that is free then
+        std::vector<std::uint8_t> free;
+        for (int room : session.rooms) {
+            if (remaining == 0) {
+                break;
+            }
+
+            free = waiting;
+            bool anyFree = true;
+            for (int week = session.firstWeek; anyFree && week <= session.lastWeek; ++week) {
+                anyFree = roomCalendars[room].filterFree(week, batch, free) &&
+                          problem.rooms[room]->filterAvailable(week, batch, free);
+            }
+            if (!anyFree) {
+                continue;
+            }
+            for (size_t i = 0; i < free.size(); ++i) {
+                if (free[i]) {
+                    candidates[i].room = room;
+                    waiting[i] = 0;
+                    --remaining;
+                }
+            }
+        }
+
+        long long bestCost = -1;
+        for (const auto& at : candidates) {
+            if (at.room == -1) {
+                continue;
+            }
+            long long cost = softCost(s, at.room, at.day, at.start);
+            if (bestCost < 0 || cost < bestCost) {
+                bestCost = cost;
+                best = at;
+            }
+        }
+
+        return bestCost >= 0;
+    }
+
+    // Greedy construction, most constrained sessions first; returns sessions placed.
+    // With shuffleTies, equally constrained sessions are taken in a random order.
+    size_t construct(bool shuffleTies) {
+        std::vector<int> order(problem.sessions.size());
+        for (size_t s = 0; s < order.size(); ++s) {
+            order[s] = static_cast<int>(s);
+            addUnplaced(static_cast<int>(s));
+        }
+
+        if (shuffleTies) {
+            std::shuffle(order.begin(), order.end(), rng);
+        }
+
+        std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+            const Session& x = problem.sessions[a];
+            const Session& y = problem.sessions[b];
+            if (x.rooms.size() != y.rooms.size()) return x.rooms.size() < y.rooms.size();
+            if (x.lastWeek - x.firstWeek != y.lastWeek - y.firstWeek) {
+                return x.lastWeek - x.firstWeek > y.lastWeek - y.firstWeek;
+            }
+            return x.duration > y.duration;
+        });
+
+        size_t placed = 0;
+        for (int s : order) {
+            Placement at;
+            if (bestPlacement(s, at)) {
+                place(s, at);
+                ++placed;
+            }
+        }
+        return placed;
+    }
+
+    // Picks a random placement for s among large enough rooms and allowed start times
+    bool randomPlacement(int s, Placement& at) {
+        const Session& session = problem.sessions[s];
+        int starts = startCount(s);
+        if (session.rooms.empty() || starts == 0) {
+            return false;
+        }
+
+        at.room = session.rooms[rng() % session.rooms.size()];
+        at.day = static_cast<int>(rng() % problem.options->days.size());
+        at.start = problem.options->dayStartMinutes + static_cast<int>(rng() % starts) * problem.options->startStepMinutes;
+        return true;
+    }
+
+    // Local search: ejection moves for unplaced sessions, cost-lowering relocations otherwise
+    void improve(long long iterations) {
+        // Only sessions moved since the last best solution are copied or rolled back
+        std::vector<Placement> best = placements;
+        long long bestScore = score();
+        clearTouched();
+
+        for (long long iteration = 0; iteration < iterations && !problem.sessions.empty(); ++iteration) {
+            if (!unplaced.empty() && (rng() & 1)) {
+                int s = unplaced[rng() % unplaced.size()];
+                Placement at;
+                if (!randomPlacement(s, at) || !externallyFree(s, at.room, at.day, at.start)) {
+                    continue;
+                }
+
+                std::vector<int> blocking = blockers(s, at.room, at.day, at.start);
+                if (blocking.size() > 1) {
+                    continue;
+                }
+
+                // Eject the single blocking session and try to put it back elsewhere
+                if (!blocking.empty()) {
+                    unplace(blocking[0]);
+                }
+                place(s, at);
+
+                Placement moved;
+                if (!blocking.empty() && bestPlacement(blocking[0], moved)) {
+                    place(blocking[0], moved);
+                }
+            } else {
+                int s = static_cast<int>(rng() % problem.sessions.size());
+                if (placements[s].room == -1) {
+                    continue;
+                }
+
+                Placement at;
+                if (!randomPlacement(s, at)) {
+                    continue;
+                }
+
+                Placement current = placements[s];
+                long long currentCost = softCost(s, current.room, current.day, current.start);
+                unplace(s);
+
+                if (feasible(s, at.room, at.day, at.start) &&
+                    softCost(s, at.room, at.day, at.start) <= currentCost) {
+                    place(s, at);
+                } else {
+                    place(s, current);
+                }
+            }
+
+            if (score() < bestScore) {
+                bestScore = score();
+                for (int s : touched) {
+                    best[s] = placements[s];
+                }
+                clearTouched();
+            }
+        }
+
+        if (score() > bestScore) {
+            std::vector<int> moved = touched;
+            for (int s : moved) {
+                if (placements[s].room != -1) {
+                    unplace(s);
+                }
+            }
+            for (int s : moved) {
+                if (best[s].room != -1) {
+                    place(s, best[s]);
+                }
+            }
+        }
+        clearTouched();
+    }
+
+    // Replaces the current placements with another set of placements
+    void restore(const std::vector<Placement>& target) {
+        for (size_t s = 0; s < placements.size(); ++s) {
+            if (placements[s].room != -1) {
+                unplace(static_cast<int>(s));
+            }
+        }
+        for (size_t s = 0; s < target.size(); ++s) {
+            if (target[s].room != -1) {
+                place(static_cast<int>(s), target[s]);
+            }
+        }
+    }
+
+    long long score() const {
+        return static_cast<long long>(unplaced.size()) * UNPLACED_PENALTY + softTotal;
+    }
+
+    long long getSoftCost() const {
+        return softTotal;
+    }
+
+    const std::vector<Placement>& getPlacements() const {
+        return placements;
+    }
+};
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Seed of one portfolio search; search 0 uses the configured seed itself
+unsigned int searchSeed(unsigned int seed, size_t search) {
+    return seed + static_cast<unsigned int>(search) * 0x9E3779B9u;
+}
+
+// Index of the lowest scoring search, the lowest index winning ties
+size_t bestSearch(const std::vector<std::unique_ptr<Search>>& searches) {
+    size_t best = 0;
+    for (size_t i = 1; i < searches.size(); ++i) {
+        if (searches[i]->score() < searches[best]->score()) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+}
+
+TimetableGenerator::TimetableGenerator(TimetableManager& manager, const std::vector<Room*>& availableRooms,
+                                       const GenerationOptions& opts)
+    : timetableManager(manager), rooms(availableRooms), options(opts) {
+}
+
+bool TimetableGenerator::addDemand(const SessionDemand& demand) {
+    if (!demand.module || !demand.sessionType || !demand.lecturer || !demand.studentGroup) {
+        return false;
+    }
+
+    if (demand.sessionsPerWeek < 1 || demand.durationMinutes < 1 ||
+        demand.durationMinutes > options.dayEndMinutes - options.dayStartMinutes) {
+        return false;
+    }
+
+    if (demand.firstWeek < 1 || demand.lastWeek > 53 || demand.firstWeek > demand.lastWeek) {
+        return false;
+    }
+
+    demands.push_back(demand);
+    return true;
+}
+
+const std::vector<SessionDemand>& TimetableGenerator::getDemands() const {
+    return demands;
+}
+
+GenerationStats TimetableGenerator::generate() {
+    GenerationStats stats;
+    Clock::time_point started = Clock::now();
+
+    if (options.days.empty() || options.startStepMinutes < 1) {
+        return stats;
+    }
+
+    // Give every lecturer, group and room a dense index and expand demands into sessions
+    Problem problem;
+    problem.options = &options;
+    problem.rooms = rooms;
+    std::sort(problem.rooms.begin(), problem.rooms.end(),
+              [](const Room* a, const Room* b) { return a->getCapacity() < b->getCapacity(); });
+
+    std::unordered_map<Lecturer*, int> lecturerIndex;
+    std::unordered_map<StudentGroup*, int> groupIndex;
+
+    for (size_t d = 0; d < demands.size(); ++d) {
+        const SessionDemand& demand = demands[d];
+
+        auto lecturer = lecturerIndex.emplace(demand.lecturer, static_cast<int>(problem.lecturers.size()));
+        if (lecturer.second) {
+            problem.lecturers.push_back(demand.lecturer);
+        }
+        auto group = groupIndex.emplace(demand.studentGroup, static_cast<int>(problem.groups.size()));
+        if (group.second) {
+            problem.groups.push_back(demand.studentGroup);
+        }
+
+        Session session;
+        session.demand = static_cast<int>(d);
+        session.lecturer = lecturer.first->second;
+        session.group = group.first->second;
+        session.duration = demand.durationMinutes;
+        session.capacity = demand.capacityNeeded;
+        session.firstWeek = demand.firstWeek;
+        session.lastWeek = demand.lastWeek;
+        for (size_t r = 0; r < problem.rooms.size(); ++r) {
+            if (problem.rooms[r]->getCapacity() >= demand.capacityNeeded) {
+                session.rooms.push_back(static_cast<int>(r));
+            }
+        }
+
+        problem.demandSessions.push_back({static_cast<int>(problem.sessions.size()), demand.sessionsPerWeek});
+        for (int i = 0; i < demand.sessionsPerWeek; ++i) {
+            problem.sessions.push_back(session);
+        }
+    }
+
+    // Existing entries of the groups involved; rooms and lecturers track their own bookings
+    problem.groupBusy.resize(problem.groups.size());
+    for (size_t g = 0; g < problem.groups.size(); ++g) {
+        for (auto entry : timetableManager.getTimetableForGroup(problem.groups[g]->getGroupID())) {
+            const WeekSet& weeks = entry->getWeeks();
+            for (int week = weeks.first(); week; week = weeks.next(week)) {
+                problem.groupBusy[g].markBusy(week, *entry->getTimeSlot());
+            }
+        }
+    }
+
+    stats.sessionsRequested = problem.sessions.size();
+
+    // One search per thread; search 0 is the plain greedy run, the others shuffle ties
+    size_t threadCount = options.threads < 1 ? 1 : options.threads;
+    std::vector<std::unique_ptr<Search>> searches;
+    for (size_t i = 0; i < threadCount; ++i) {
+        searches.push_back(std::make_unique<Search>(problem, searchSeed(options.seed, i)));
+    }
+    ThreadPool pool(threadCount);
+    stats.threadsUsed = threadCount;
+
+    // Construction phase
+    std::vector<size_t> constructed(threadCount);
+    Clock::time_point constructionStart = Clock::now();
+    for (size_t i = 0; i < threadCount; ++i) {
+        pool.submit([&, i] { constructed[i] = searches[i]->construct(i > 0); });
+    }
+    pool.wait();
+    stats.constructionSeconds = secondsSince(constructionStart);
+
+    size_t totalConstructed = 0;
+    for (size_t placed : constructed) {
+        totalConstructed += placed;
+    }
+    stats.placementsPerSecond = stats.constructionSeconds > 0.0
+        ? totalConstructed / stats.constructionSeconds : 0.0;
+
+    // Improvement phase: the move budget is split evenly between searches and epochs.
+    // After each epoch every search adopts the best solution found so far, so the
+    // result only depends on the seed and thread count, not on thread timing.
+    int epochs = threadCount > 1 ? std::max(1, options.shareEpochs) : 1;
+    long long budget = std::max(0, options.improvementIterations);
+    long long perSearch = (budget + static_cast<long long>(threadCount) * epochs - 1) /
+                          (static_cast<long long>(threadCount) * epochs);
+
+    Clock::time_point improvementStart = Clock::now();
+    for (int epoch = 0; epoch < epochs; ++epoch) {
+        for (size_t i = 0; i < threadCount; ++i) {
+            pool.submit([&, i] { searches[i]->improve(perSearch); });
+        }
+        pool.wait();
+        stats.movesTried += perSearch * threadCount;
+
+        size_t best = bestSearch(searches);
+        if (epoch + 1 == epochs) {
+            std::swap(searches[0], searches[best]);
+            break;
+        }
+
+        for (size_t i = 0; i < threadCount; ++i) {
+            if (i != best && searches[best]->score() < searches[i]->score()) {
+                pool.submit([&, i, best] { searches[i]->restore(searches[best]->getPlacements()); });
+            }
+        }
+        pool.wait();
+    }
+    stats.improvementSeconds = secondsSince(improvementStart);
+    stats.movesPerSecond = stats.improvementSeconds > 0.0
+        ? stats.movesTried / stats.improvementSeconds : 0.0;
+
+    const Search& search = *searches[0];
+    stats.softCost = search.getSoftCost();
+
+    {
+        // Commit every placed session as one entry running in all its weeks, published together
+        TimetableManager::UpdateBatch batch(timetableManager);
+        const std::vector<Placement>& placements = search.getPlacements();
+        for (size_t s = 0; s < placements.size(); ++s) {
+            const Placement& at = placements[s];
+            if (at.room == -1) {
+                continue;
+            }
+
+            const Session& session = problem.sessions[s];
+            const SessionDemand& demand = demands[session.demand];
+            TimeSlot slot(options.days[at.day], at.start, at.start + session.duration);
+            if (timetableManager.createRecurringEntry(WeekSet::range(session.firstWeek, session.lastWeek),
+                                                      demand.module, demand.lecturer, problem.rooms[at.room],
+                                                      demand.studentGroup, demand.sessionType, slot)) {
+                ++stats.sessionsPlaced;
+                ++stats.entriesCreated;
+            }
+        }
+    }
+
+    stats.totalSeconds = secondsSince(started);
+    return stats;
+}
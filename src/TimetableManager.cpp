@@ -1,20 +1,236 @@
 
 #include "../include/TimetableManager.h"
+#include "../include/MappedFile.h"
+#include "../include/GlobalVariables.h"
 #include <fstream>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <charconv>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <tuple>
+
+namespace {
+
+// Columns written by exportToCSV and expected by importFromCSV
+const char* const CSV_COLUMNS[] = {
+    "EntryID", "Week", "Module", "ModuleCode", "Lecturer", "Room",
+    "StudentGroup", "SessionType", "Day", "StartTime", "EndTime"
+};
+const size_t CSV_COLUMN_COUNT = sizeof(CSV_COLUMNS) / sizeof(CSV_COLUMNS[0]);
+
+// Preferred teaching hours; findFreeSlots counts each minute outside them against an option
+const int CORE_START = 10 * 60;
+const int CORE_END = 17 * 60;
+
+// Writes a CSV field, quoting it if it contains a separator, quote or line break
+void writeField(std::ostream& out, std::string_view field) {
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out << field;
+        return;
+    }
+
+    out << '"';
+    for (char c : field) {
+        if (c == '"') {
+            out << '"';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+// Splits CSV text into rows in a single pass. Fields are views into the
+// text; only quoted fields containing escaped quotes are copied.
+class CSVReader {
+private:
+    std::string_view text;
+    size_t pos;
+    std::deque<std::string> unescaped; // Deque so earlier fields stay put as it grows
+
+public:
+    explicit CSVReader(std::string_view csv) : text(csv), pos(0) {
+    }
+
+    bool nextRow(std::vector<std::string_view>& fields) {
+        fields.clear();
+        unescaped.clear();
+        if (pos >= text.size()) {
+            return false;
+        }
+
+        while (true) {
+            if (pos < text.size() && text[pos] == '"') {
+                size_t begin = ++pos;
+                bool escaped = false;
+                while (pos < text.size()) {
+                    if (text[pos] == '"') {
+                        if (pos + 1 < text.size() && text[pos + 1] == '"') {
+                            escaped = true;
+                            pos += 2;
+                            continue;
+                        }
+                        break;
+                    }
+                    ++pos;
+                }
+
+                std::string_view field = text.substr(begin, pos - begin);
+                if (escaped) {
+                    std::string& copy = unescaped.emplace_back();
+                    for (size_t i = 0; i < field.size(); ++i) {
+                        copy += field[i];
+                        if (field[i] == '"') {
+                            ++i;
+                        }
+                    }
+                    field = copy;
+                }
+                fields.push_back(field);
+
+                // Skip the closing quote and anything up to the next separator
+                while (pos < text.size() && text[pos] != ',' && text[pos] != '\n') {
+                    ++pos;
+                }
+            } else {
+                size_t end = text.find_first_of(",\n", pos);
+                if (end == std::string_view::npos) {
+                    end = text.size();
+                }
+                fields.push_back(text.substr(pos, end - pos));
+                pos = end;
+            }
+
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+
+            // End of row: drop a trailing carriage return and step over the newline
+            std::string_view& last = fields.back();
+            if (!last.empty() && last.back() == '\r') {
+                last.remove_suffix(1);
+            }
+            if (pos < text.size()) {
+                ++pos;
+            }
+            return true;
+        }
+    }
+};
+
+// Keys are views of interned names, which stay valid for as long as the map is used
+template <typename T>
+using NameMap = std::unordered_map<std::string_view, T*>;
+
+template <typename T, typename KeyOf>
+NameMap<T> buildNameMap(const std::vector<T*>& items, KeyOf keyOf) {
+    NameMap<T> map;
+    map.reserve(items.size());
+    for (T* item : items) {
+        // The first of several items with the same name wins
+        map.emplace(keyOf(item), item);
+    }
+    return map;
+}
+
+template <typename T>
+T* lookup(const NameMap<T>& map, std::string_view key) {
+    auto it = map.find(key);
+    return it != map.end() ? it->second : nullptr;
+}
+
+// Number of a generated "TTnnnn" ID, or -1 for any other ID
+int generatedIDNumber(std::string_view entryID) {
+    if (entryID.size() < 3 || entryID.substr(0, 2) != "TT") {
+        return -1;
+    }
+
+    int number = -1;
+    auto result = std::from_chars(entryID.data() + 2, entryID.data() + entryID.size(), number);
+    return result.ec == std::errc() && result.ptr == entryID.data() + entryID.size() ? number : -1;
+}
+
+}
 
 TimetableManager::TimetableManager(const std::string& year, const std::string& sem)
-    : academicYear(year), semester(sem) {
+    : academicYear(year), semester(sem), publishedEpoch(0), liveEpochs(std::make_shared<LiveEpochs>()),
+      batchDepth(0), unpublished(false), nextEntryNumber(1) {
+    // Readers always find a version, even before the first change
+    publish();
 }
 
 TimetableManager::~TimetableManager() {
-    // Clean up all timetable entries
-    for (auto entry : timetableEntries) {
-        delete entry;
+    // Free all timetable entries at once with their pool, retired ones included
+    published.reset();
+    working.columns.clear();
+    entryPool.clear();
+}
+
+TimetableManager::UpdateBatch::UpdateBatch(TimetableManager& timetable) : manager(timetable) {
+    ++manager.batchDepth;
+}
+
+TimetableManager::UpdateBatch::~UpdateBatch() {
+    if (--manager.batchDepth == 0 && manager.unpublished) {
+        manager.publish();
+    }
+}
+
+void TimetableManager::changed() {
+    if (batchDepth > 0) {
+        unpublished = true;
+    } else {
+        publish();
+    }
+}
+
+void TimetableManager::publish() {
+    // The copy shares index nodes and column chunks with working, which copies one before changing it from now on
+    TimetableVersion* version = new TimetableVersion(working);
+    publishedEpoch = working.epoch++;
+    {
+        std::lock_guard<std::mutex> lock(liveEpochs->mutex);
+        liveEpochs->epochs.insert(publishedEpoch);
+    }
+
+    // The last reader to let go of a version, on whatever thread, drops its epoch from the live set
+    std::shared_ptr<LiveEpochs> live = liveEpochs;
+    std::shared_ptr<const TimetableVersion> latest(version, [live](const TimetableVersion* old) {
+        {
+            std::lock_guard<std::mutex> lock(live->mutex);
+            live->epochs.erase(old->epoch);
+        }
+        delete old;
+    });
+
+    // Readers only hold the lock to copy the pointer; the previous version is released after it
+    {
+        std::lock_guard<std::mutex> lock(publishedMutex);
+        published.swap(latest);
+    }
+    latest.reset();
+    unpublished = false;
+
+    // Entries retired before the oldest version still held cannot be listed by any version
+    std::uint64_t oldest;
+    {
+        std::lock_guard<std::mutex> lock(liveEpochs->mutex);
+        oldest = liveEpochs->epochs.empty() ? publishedEpoch + 1 : *liveEpochs->epochs.begin();
+    }
+    auto freed = std::partition(retired.begin(), retired.end(),
+                                [oldest](const auto& item) { return item.first >= oldest; });
+    for (auto it = freed; it != retired.end(); ++it) {
+        entryPool.destroy(it->second);
     }
-    timetableEntries.clear();
+    retired.erase(freed, retired.end());
+}
+
+std::shared_ptr<const TimetableVersion> TimetableManager::getPublishedVersion() const {
+    std::lock_guard<std::mutex> lock(publishedMutex);
+    return published;
 }
 
 std::string TimetableManager::getAcademicYear() const {
@@ -25,48 +241,101 @@ std::string TimetableManager::getSemester() const {
     return semester;
 }
 
-std::string TimetableManager::generateEntryID() const {
-    // Generate a unique ID based on the current number of entries
-    std::stringstream ss;
-    ss << "TT" << std::setw(4) << std::setfill('0') << (timetableEntries.size() + 1);
-    return ss.str();
+void TimetableManager::reserveEntryID(const std::string& entryID) {
+    int number = generatedIDNumber(entryID);
+    if (number >= nextEntryNumber) {
+        nextEntryNumber = number + 1;
+    }
 }
 
-TimetableEntry* TimetableManager::createEntry(int week, Module* mod, Lecturer* lec,
-                                           Room* rm, StudentGroup* group,
-                                           SessionType* session, TimeSlot* time) {
+std::string TimetableManager::generateEntryID() {
+    // Numbers are never reused, so IDs stay unique after deletes and imports
+    std::string entryID;
+    do {
+        std::stringstream ss;
+        ss << "TT" << std::setw(4) << std::setfill('0') << nextEntryNumber++;
+        entryID = ss.str();
+    } while (entriesByID.count(entryID));
+    return entryID;
+}
+
+bool TimetableManager::canSchedule(const WeekSet& weeks, Module* mod, Lecturer* lec, Room* rm, StudentGroup* group,
+                                   SessionType* session, const TimeSlot& time) const {
     // Validate input parameters
-    if (!mod || !lec || !rm || !group || !session || !time) {
-        return nullptr;
+    if (!mod || !lec || !rm || !group || !session) {
+        return false;
     }
 
-    // Check if the week number is valid (1-53)
-    if (week < 1 || week > 53) {
-        return nullptr;
+    // Check the time slot was parsed and ends after it starts
+    if (!time.isValid()) {
+        return false;
     }
 
-    // Check if the lecturer is available at this time
-    if (!lec->isAvailable(*time)) {
-        return nullptr;
+    // Check there is at least one week and every week is valid (1-53)
+    if (!weeks.isValid()) {
+        return false;
     }
 
-    // Check if the room is available at this time
-    if (!rm->isAvailable(*time)) {
-        return nullptr;
+    // Check if the lecturer and room are available at this time in every week
+    for (int week = weeks.first(); week; week = weeks.next(week)) {
+        if (!lec->isAvailable(week, time) || !rm->isAvailable(week, time)) {
+            return false;
+        }
     }
+    return true;
+}
 
-    // Generate a unique ID for the entry
-    std::string entryID = generateEntryID();
-
+TimetableEntry* TimetableManager::storeEntry(const std::string& entryID, const WeekSet& weeks, Module* mod,
+                                             Lecturer* lec, Room* rm, StudentGroup* group, SessionType* session,
+                                             const TimeSlot& time) {
     // Create the new entry
-    TimetableEntry* newEntry = new TimetableEntry(entryID, week, mod, lec, rm, group, session, time);
+    TimetableEntry* newEntry = entryPool.create(entryID, weeks, mod, lec, rm, group, session, time);
+
+    // Register the time slot with the lecturer and room in every week
+    for (int week = weeks.first(); week; week = weeks.next(week)) {
+        lec->addToSchedule(week, time);
+        rm->bookTimeSlot(week, time);
+    }
 
     // Add to the collection
-    timetableEntries.push_back(newEntry);
+    working.add(newEntry);
+    entriesByID.emplace(entryID, newEntry);
+
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::CreateEntry)
+                              .str(entryID)
+                              .u64(weeks.getBits())
+                              .str(mod->getModuleCode())
+                              .str(lec->getLecturerID())
+                              .str(rm->getRoomID())
+                              .str(group->getGroupID())
+                              .str(session->getTypeID())
+                              .u8(static_cast<std::uint8_t>(time.getDayOfWeek()))
+                              .u16(static_cast<std::uint16_t>(time.getStartMinutes()))
+                              .u16(static_cast<std::uint16_t>(time.getEndMinutes())));
+    }
+    return newEntry;
+}
+
+TimetableEntry* TimetableManager::createEntry(int week, Module* mod, Lecturer* lec,
+                                           Room* rm, StudentGroup* group,
+                                           SessionType* session, const TimeSlot& time) {
+    return createRecurringEntry(WeekSet::single(week), mod, lec, rm, group, session, time);
+}
 
-    // Check for conflicts
-    checkForConflicts();
+TimetableEntry* TimetableManager::createRecurringEntry(const WeekSet& weeks, Module* mod, Lecturer* lec,
+                                                    Room* rm, StudentGroup* group,
+                                                    SessionType* session, const TimeSlot& time) {
+    if (!canSchedule(weeks, mod, lec, rm, group, session, time)) {
+        return nullptr;
+    }
 
+    TimetableEntry* newEntry = storeEntry(generateEntryID(), weeks, mod, lec, rm, group, session, time);
+
+    // Record any conflicts the new entry causes
+    conflictDetector.addEntry(newEntry);
+
+    changed();
     return newEntry;
 }
 
@@ -74,20 +343,7 @@ std::vector<TimetableEntry*> TimetableManager::searchTimetable(int week,
                                                             const std::string& moduleCode,
                                                             const std::string& roomID,
                                                             const std::string& lecturerID) const {
-    std::vector<TimetableEntry*> results;
-
-    for (auto entry : timetableEntries) {
-        bool matchesWeek = (week == -1) || (entry->getWeekNumber() == week);
-        bool matchesModule = moduleCode.empty() || (entry->getModule()->getModuleCode() == moduleCode);
-        bool matchesRoom = roomID.empty() || (entry->getRoom()->getRoomID() == roomID);
-        bool matchesLecturer = lecturerID.empty() || (entry->getLecturer()->getLecturerID() == lecturerID);
-
-        if (matchesWeek && matchesModule && matchesRoom && matchesLecturer) {
-            results.push_back(entry);
-        }
-    }
-
-    return results;
+    return working.searchTimetable(week, moduleCode, roomID, lecturerID);
 }
 
 bool TimetableManager::exportToCSV(const std::string& filename) const {
@@ -97,99 +353,334 @@ bool TimetableManager::exportToCSV(const std::string& filename) const {
     }
 
     // Write header
-    file << "EntryID,Week,Module,ModuleCode,Lecturer,Room,StudentGroup,SessionType,Day,StartTime,EndTime\n";
-
-    // Write data
-    for (const auto& entry : timetableEntries) {
-        file << entry->getEntryID() << ","
-             << entry->getWeekNumber() << ","
-             << entry->getModule()->getTitle() << ","
-             << entry->getModule()->getModuleCode() << ","
-             << entry->getLecturer()->getName() << ","
-             << entry->getRoom()->getRoomID() << ","
-             << entry->getStudentGroup()->getGroupName() << ","
-             << entry->getSessionType()->getTypeName() << ","
-             << entry->getTimeSlot()->getDay() << ","
+    for (size_t column = 0; column < CSV_COLUMN_COUNT; ++column) {
+        file << (column ? "," : "") << CSV_COLUMNS[column];
+    }
+    file << "\n";
+
+    // Write data, one row per week of each entry; the fields after the week are the same in each
+    std::stringstream rest;
+    for (const auto& entry : working.getEntries()) {
+        rest.str("");
+        writeField(rest, entry->getModule()->getTitle());
+        rest << ",";
+        writeField(rest, entry->getModule()->getModuleCode());
+        rest << ",";
+        writeField(rest, entry->getLecturer()->getName());
+        rest << ",";
+        writeField(rest, entry->getRoom()->getRoomID());
+        rest << ",";
+        writeField(rest, entry->getStudentGroup()->getGroupName());
+        rest << ",";
+        writeField(rest, entry->getSessionType()->getTypeName());
+        rest << "," << entry->getTimeSlot()->getDay() << ","
              << entry->getTimeSlot()->getStartTime() << ","
              << entry->getTimeSlot()->getEndTime() << "\n";
+
+        const WeekSet& weeks = entry->getWeeks();
+        for (int week = weeks.first(); week; week = weeks.next(week)) {
+            writeField(file, entry->getEntryID());
+            file << "," << week << "," << rest.view();
+        }
     }
 
     file.close();
     return true;
 }
 
-std::vector<TimetableEntry*> TimetableManager::getTimetableForGroup(const std::string& groupID, int week) const {
-    std::vector<TimetableEntry*> results;
+bool TimetableManager::importFromCSV(const std::string& filename,
+                                     const std::vector<Module*>& modules,
+                                     const std::vector<Lecturer*>& lecturers,
+                                     const std::vector<Room*>& rooms,
+                                     const std::vector<StudentGroup*>& groups,
+                                     const std::vector<SessionType*>& sessionTypes,
+                                     ImportSummary* summary) {
+    ImportSummary counts;
+
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
 
-    for (auto entry : timetableEntries) {
-        bool matchesWeek = (week == -1) || (entry->getWeekNumber() == week);
-        bool matchesGroup = entry->getStudentGroup()->getGroupID() == groupID;
+    CSVReader reader(file.contents());
+    std::vector<std::string_view> fields;
 
-        if (matchesWeek && matchesGroup) {
-            results.push_back(entry);
+    // The header must match the export format exactly
+    if (!reader.nextRow(fields) || fields.size() != CSV_COLUMN_COUNT) {
+        return false;
+    }
+    for (size_t column = 0; column < CSV_COLUMN_COUNT; ++column) {
+        if (fields[column] != CSV_COLUMNS[column]) {
+            return false;
         }
     }
 
-    return results;
-}
+    // Resolve references through hash lookups rather than scanning the lists per row
+    auto modulesByCode = buildNameMap(modules, [](Module* m) { return m->getModuleCode(); });
+    auto lecturersByName = buildNameMap(lecturers, [](Lecturer* l) { return l->getName(); });
+    auto roomsByID = buildNameMap(rooms, [](Room* r) { return r->getRoomID(); });
+    auto groupsByName = buildNameMap(groups, [](StudentGroup* g) { return g->getGroupName(); });
+    auto sessionTypesByName = buildNameMap(sessionTypes, [](SessionType* t) { return t->getTypeName(); });
+
+    // Rows of the same entry in different weeks are gathered into one entry before any is stored
+    struct PendingEntry {
+        std::string entryID;
+        WeekSet weeks;
+        Module* mod;
+        Lecturer* lec;
+        Room* rm;
+        StudentGroup* group;
+        SessionType* session;
+        TimeSlot time;
+        size_t rows;
+    };
+    std::vector<PendingEntry> pending;
+    std::unordered_map<std::string, size_t> pendingByID;
+
+    while (reader.nextRow(fields)) {
+        // Blank lines are not rows
+        if (fields.size() == 1 && fields[0].empty()) {
+            continue;
+        }
+        ++counts.rowsRead;
+
+        if (fields.size() != CSV_COLUMN_COUNT || fields[0].empty()) {
+            ++counts.rowsSkipped;
+            continue;
+        }
 
-std::vector<TimetableEntry*> TimetableManager::getTimetableForLecturer(const std::string& lecturerID, int week) const {
-    std::vector<TimetableEntry*> results;
+        std::string entryID(fields[0]);
+        int week = 0;
+        auto weekResult = std::from_chars(fields[1].data(), fields[1].data() + fields[1].size(), week);
+        if (weekResult.ec != std::errc() || weekResult.ptr != fields[1].data() + fields[1].size() ||
+            week < WeekSet::FIRST_WEEK || week > WeekSet::LAST_WEEK || entriesByID.count(entryID)) {
+            ++counts.rowsSkipped;
+            continue;
+        }
 
-    for (auto entry : timetableEntries) {
-        bool matchesWeek = (week == -1) || (entry->getWeekNumber() == week);
-        bool matchesLecturer = entry->getLecturer()->getLecturerID() == lecturerID;
+        Module* mod = lookup(modulesByCode, fields[3]);
+        Lecturer* lec = lookup(lecturersByName, fields[4]);
+        Room* rm = lookup(roomsByID, fields[5]);
+        StudentGroup* group = lookup(groupsByName, fields[6]);
+        SessionType* session = lookup(sessionTypesByName, fields[7]);
+        TimeSlot time(TimeSlot::parseDay(fields[8]), TimeSlot::timeToMinutes(fields[9]),
+                      TimeSlot::timeToMinutes(fields[10]));
+
+        auto [it, isNew] = pendingByID.emplace(entryID, pending.size());
+        if (isNew) {
+            pending.push_back({std::move(entryID), WeekSet::single(week), mod, lec, rm, group, session, time, 1});
+            continue;
+        }
 
-        if (matchesWeek && matchesLecturer) {
-            results.push_back(entry);
+        PendingEntry& entry = pending[it->second];
+        if (entry.weeks.contains(week) || entry.mod != mod || entry.lec != lec || entry.rm != rm ||
+            entry.group != group || entry.session != session ||
+            entry.time.getDayOfWeek() != time.getDayOfWeek() || entry.time.getStartMinutes() != time.getStartMinutes() ||
+            entry.time.getEndMinutes() != time.getEndMinutes()) {
+            ++counts.rowsSkipped;
+            continue;
         }
+        entry.weeks.add(week);
+        ++entry.rows;
+    }
+
+    for (const auto& entry : pending) {
+        if (!canSchedule(entry.weeks, entry.mod, entry.lec, entry.rm, entry.group, entry.session, entry.time)) {
+            counts.rowsSkipped += entry.rows;
+            continue;
+        }
+
+        storeEntry(entry.entryID, entry.weeks, entry.mod, entry.lec, entry.rm, entry.group, entry.session, entry.time);
+        reserveEntryID(entry.entryID);
+        ++counts.entriesImported;
+    }
+
+    // One conflict pass and one published version for the whole import instead of one per row
+    if (counts.entriesImported > 0) {
+        conflictDetector.detectConflicts(working.columns);
+        changed();
     }
 
-    return results;
+    if (summary) {
+        *summary = counts;
+    }
+    return true;
 }
 
-std::vector<TimetableEntry*> TimetableManager::getTimetableForRoom(const std::string& roomID, int week) const {
-    std::vector<TimetableEntry*> results;
+std::vector<SlotOption> TimetableManager::findFreeSlots(const SlotQuery& query,
+                                                        const std::vector<Room*>& rooms) const {
+    std::vector<SlotOption> options;
+    if (query.limit == 0 || query.durationMinutes <= 0 || query.startStepMinutes <= 0 ||
+        query.firstWeek < 1 || query.lastWeek > OccupancyCalendar::WEEKS || query.firstWeek > query.lastWeek) {
+        return options;
+    }
 
-    for (auto entry : timetableEntries) {
-        bool matchesWeek = (week == -1) || (entry->getWeekNumber() == week);
-        bool matchesRoom = entry->getRoom()->getRoomID() == roomID;
+    // Every allowed (day, start), with the minutes it runs outside core hours
+    std::vector<TimeSlot> slots;
+    std::vector<int> offPeak;
+    for (auto day : query.days) {
+        for (int start = query.dayStartMinutes; start + query.durationMinutes <= query.dayEndMinutes;
+             start += query.startStepMinutes) {
+            int end = start + query.durationMinutes;
+            slots.emplace_back(day, start, end);
+            offPeak.push_back(std::max(0, CORE_START - start) + std::max(0, end - CORE_END));
+        }
+    }
+    if (slots.empty()) {
+        return options;
+    }
+    SlotBatch batch(slots);
+
+    // Groups have no calendar of their own, so mark the group's entries in the range into one
+    OccupancyCalendar groupBusy;
+    if (query.group) {
+        for (auto entry : working.getTimetableForGroup(query.group->getGroupID(), -1)) {
+            const WeekSet& weeks = entry->getWeeks();
+            for (int week = weeks.next(query.firstWeek - 1); week && week <= query.lastWeek; week = weeks.next(week)) {
+                groupBusy.markBusy(week, *entry->getTimeSlot());
+            }
+        }
+    }
 
-        if (matchesWeek && matchesRoom) {
-            results.push_back(entry);
+    // Times when the lecturer and group are free in every week
+    std::vector<std::uint8_t> waiting(slots.size(), 1);
+    bool any = true;
+    for (int week = query.firstWeek; any && week <= query.lastWeek; ++week) {
+        any = (!query.lecturer || query.lecturer->filterAvailable(week, batch, waiting)) &&
+              groupBusy.filterFree(week, batch, waiting);
+    }
+    if (!any) {
+        return options;
+    }
+
+    int leastOffPeak = std::numeric_limits<int>::max();
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (waiting[i]) {
+            leastOffPeak = std::min(leastOffPeak, offPeak[i]);
         }
     }
 
-    return results;
+    // Large enough rooms, fewest empty seats first
+    std::vector<size_t> order;
+    for (size_t r = 0; r < rooms.size(); ++r) {
+        if (rooms[r] && rooms[r]->getCapacity() >= query.minCapacity) {
+            order.push_back(r);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&rooms](size_t a, size_t b) {
+        return rooms[a]->getCapacity() < rooms[b]->getCapacity();
+    });
+
+    // The best options so far as (score, slot, room) tuples, kept as a max-heap of at most limit
+    using Ranked = std::tuple<long long, size_t, size_t>;
+    std::vector<Ranked> best;
+    std::vector<std::uint8_t> free;
+    for (size_t r : order) {
+        long long emptySeats = rooms[r]->getCapacity() - query.minCapacity;
+
+        // Later rooms have at least as many empty seats, so none of their options can rank higher
+        if (best.size() == query.limit && emptySeats + leastOffPeak > std::get<0>(best.front())) {
+            break;
+        }
+
+        free = waiting;
+        bool anyFree = true;
+        for (int week = query.firstWeek; anyFree && week <= query.lastWeek; ++week) {
+            anyFree = rooms[r]->filterAvailable(week, batch, free);
+        }
+        if (!anyFree) {
+            continue;
+        }
+
+        for (size_t i = 0; i < free.size(); ++i) {
+            if (!free[i]) {
+                continue;
+            }
+            Ranked option(emptySeats + offPeak[i], i, r);
+            if (best.size() < query.limit) {
+                best.push_back(option);
+                std::push_heap(best.begin(), best.end());
+            } else if (option < best.front()) {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = option;
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    options.reserve(best.size());
+    for (const auto& [score, slot, room] : best) {
+        options.push_back({rooms[room], slots[slot], score});
+    }
+    return options;
+}
+
+std::vector<TimetableEntry*> TimetableManager::getTimetableForGroup(std::string_view groupID, int week) const {
+    return working.getTimetableForGroup(groupID, week);
 }
 
-void TimetableManager::checkForConflicts() {
-    conflictDetector.detectConflicts(timetableEntries);
+std::vector<TimetableEntry*> TimetableManager::getTimetableForLecturer(std::string_view lecturerID, int week) const {
+    return working.getTimetableForLecturer(lecturerID, week);
+}
+
+std::vector<TimetableEntry*> TimetableManager::getTimetableForRoom(std::string_view roomID, int week) const {
+    return working.getTimetableForRoom(roomID, week);
+}
+
+void TimetableManager::checkForConflicts(unsigned int threads) {
+    conflictDetector.detectConflicts(working.columns, threads);
+}
+
+bool TimetableManager::verifyConflicts() const {
+    return conflictDetector.verifyConflicts(working.columns);
 }
 
 bool TimetableManager::hasConflicts() const {
     return conflictDetector.hasConflicts();
 }
 
-std::vector<std::pair<TimetableEntry*, TimetableEntry*>> TimetableManager::getConflicts() const {
+std::span<const Conflict> TimetableManager::getConflicts() const {
     return conflictDetector.getConflicts();
 }
 
+size_t TimetableManager::getConflictCount(Conflict::Kind kind) const {
+    return conflictDetector.getConflictCount(kind);
+}
+
+std::string TimetableManager::suggestResolution(const Conflict& conflict) const {
+    return conflictDetector.suggestResolution(conflict);
+}
+
 bool TimetableManager::deleteEntry(const std::string& entryID) {
-    auto it = std::find_if(timetableEntries.begin(), timetableEntries.end(),
-                           [&entryID](const TimetableEntry* entry) {
-                               return entry->getEntryID() == entryID;
-                           });
+    auto found = entriesByID.find(entryID);
+    if (found == entriesByID.end()) {
+        return false;
+    }
+
+    TimetableEntry* entry = found->second;
+    conflictDetector.removeEntry(entry);
+    working.remove(entry);
 
-    if (it != timetableEntries.end()) {
-        delete *it;
-        timetableEntries.erase(it);
-        return true;
+    // Free the time slot for the lecturer and room in every week
+    const WeekSet& weeks = entry->getWeeks();
+    for (int week = weeks.first(); week; week = weeks.next(week)) {
+        entry->getLecturer()->removeFromSchedule(week, *entry->getTimeSlot());
+        entry->getRoom()->releaseTimeSlot(week, *entry->getTimeSlot());
     }
 
-    return false;
+    entriesByID.erase(found);
+
+    // Published versions may still list the entry, so it is freed once they are released
+    retired.emplace_back(publishedEpoch, entry);
+
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::DeleteEntry).str(entryID));
+    }
+    changed();
+    return true;
 }
 
-const std::vector<TimetableEntry*>& TimetableManager::getAllEntries() const {
-    return timetableEntries;
+std::vector<TimetableEntry*> TimetableManager::getAllEntries() const {
+    return working.getEntries();
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "../include/TimetableVersion.h"
+#include "../include/GlobalVariables.h"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Searches scan the entry columns once the best index partition holds at least
+// this fraction of all entries, since a column row is far cheaper to test than
+// an entry reached through its pointers
+const size_t SCAN_RATIO = 16;
+
+}
+
+TimetableVersion::TimetableVersion() : epoch(1) {
+}
+
+std::uint64_t TimetableVersion::getEpoch() const {
+    return epoch;
+}
+
+template <typename Node>
+Node& TimetableVersion::own(std::shared_ptr<Node>& node) {
+    if (!node) {
+        node = std::make_shared<Node>();
+    } else if (node->epoch != epoch) {
+        // Published versions keep the old node
+        node = std::make_shared<Node>(*node);
+    }
+    node->epoch = epoch;
+    return *node;
+}
+
+TimetableVersion::EntryList& TimetableVersion::ownList(Index& index, StringInterner::Symbol symbol) {
+    if (symbol / INDEX_CHUNK_SYMBOLS >= index.size()) {
+        index.resize(symbol / INDEX_CHUNK_SYMBOLS + 1);
+    }
+    return own(own(index[symbol / INDEX_CHUNK_SYMBOLS]).lists[symbol % INDEX_CHUNK_SYMBOLS]);
+}
+
+void TimetableVersion::add(TimetableEntry* entry) {
+    columns.append(entry, epoch);
+
+    // The entry is the newest, so it goes after every entry with the same first week
+    int first = entry->getWeeks().first();
+    auto add = [this, entry, first](Index& index, StringInterner::Symbol symbol) {
+        EntryList& list = ownList(index, symbol);
+        list.entries.push_back(entry);
+        list.byFirstWeek.insert(std::upper_bound(list.byFirstWeek.begin(), list.byFirstWeek.end(), first,
+                                                 [](int week, const TimetableEntry* other) {
+                                                     return week < other->getWeeks().first();
+                                                 }),
+                                entry);
+    };
+
+    add(groupIndex, entry->getStudentGroup()->getGroupSymbol());
+    add(lecturerIndex, entry->getLecturer()->getLecturerSymbol());
+    add(roomIndex, entry->getRoom()->getRoomSymbol());
+    add(moduleIndex, entry->getModule()->getModuleSymbol());
+}
+
+void TimetableVersion::remove(TimetableEntry* entry) {
+    auto remove = [this, entry](Index& index, StringInterner::Symbol symbol) {
+        EntryList& list = ownList(index, symbol);
+        list.entries.erase(std::find(list.entries.begin(), list.entries.end(), entry));
+        list.byFirstWeek.erase(std::find(list.byFirstWeek.begin(), list.byFirstWeek.end(), entry));
+    };
+
+    remove(groupIndex, entry->getStudentGroup()->getGroupSymbol());
+    remove(lecturerIndex, entry->getLecturer()->getLecturerSymbol());
+    remove(roomIndex, entry->getRoom()->getRoomSymbol());
+    remove(moduleIndex, entry->getModule()->getModuleSymbol());
+
+    columns.erase(columns.findRow(entry), epoch);
+}
+
+const TimetableVersion::EntryList* TimetableVersion::findList(const Index& index, std::string_view key) {
+    // An ID that was never interned cannot be in any index
+    StringInterner::Symbol symbol = g_strings.find(key);
+    if (symbol == StringInterner::NONE || symbol / INDEX_CHUNK_SYMBOLS >= index.size() ||
+        !index[symbol / INDEX_CHUNK_SYMBOLS]) {
+        return nullptr;
+    }
+    return index[symbol / INDEX_CHUNK_SYMBOLS]->lists[symbol % INDEX_CHUNK_SYMBOLS].get();
+}
+
+std::vector<TimetableEntry*> TimetableVersion::collect(const EntryList* list, int week) {
+    std::vector<TimetableEntry*> results;
+    if (!list) {
+        return results;
+    }
+
+    if (week == -1) {
+        results = list->byFirstWeek;
+    } else {
+        for (auto entry : list->entries) {
+            if (entry->getWeeks().contains(week)) {
+                results.push_back(entry);
+            }
+        }
+    }
+
+    return results;
+}
+
+std::vector<TimetableEntry*> TimetableVersion::searchTimetable(int week,
+                                                               const std::string& moduleCode,
+                                                               const std::string& roomID,
+                                                               const std::string& lecturerID) const {
+    // Start from the smallest index list among the given criteria
+    const EntryList* candidates = nullptr;
+    size_t candidateCount = 0;
+    bool anyKey = false;
+
+    auto consider = [&](const Index& index, const std::string& key) {
+        if (key.empty()) {
+            return true;
+        }
+
+        const EntryList* list = findList(index, key);
+        if (!list) {
+            return false; // Nothing can match this criterion
+        }
+
+        if (!anyKey || list->entries.size() < candidateCount) {
+            candidates = list;
+            candidateCount = list->entries.size();
+            anyKey = true;
+        }
+        return true;
+    };
+
+    if (!consider(moduleIndex, moduleCode) || !consider(roomIndex, roomID) ||
+        !consider(lecturerIndex, lecturerID)) {
+        return {};
+    }
+
+    if (!anyKey && week == -1) {
+        return columns.getEntries();
+    }
+
+    // Every given ID has entries, so it is interned and entries can be matched by symbol
+    StringInterner::Symbol module = g_strings.find(moduleCode);
+    StringInterner::Symbol room = g_strings.find(roomID);
+    StringInterner::Symbol lecturer = g_strings.find(lecturerID);
+
+    std::vector<TimetableEntry*> results;
+
+    // Filtering a large list entry by entry costs more than scanning every row's columns
+    if (!anyKey || candidateCount * SCAN_RATIO >= columns.count()) {
+        EntryColumns::Filter filter;
+        filter.week = week;
+        if (!moduleCode.empty()) filter.module = columns.findID(EntryColumns::Key::Module, module);
+        if (!roomID.empty()) filter.room = columns.findID(EntryColumns::Key::Room, room);
+        if (!lecturerID.empty()) filter.lecturer = columns.findID(EntryColumns::Key::Lecturer, lecturer);
+
+        std::vector<std::uint32_t> rows;
+        columns.select(filter, rows);
+
+        results.resize(rows.size());
+        if (week != -1) {
+            for (size_t i = 0; i < rows.size(); ++i) {
+                results[i] = columns.getEntry(rows[i]);
+            }
+            return results;
+        }
+
+        // Rows come in creation order; results spanning all weeks are ordered by first week,
+        // which takes one counting pass since there are only as many first weeks as bits
+        size_t starts[65] = {};
+        for (auto row : rows) {
+            ++starts[std::countr_zero(columns.getWeeks(row)) + 1];
+        }
+        for (size_t bit = 1; bit < 65; ++bit) {
+            starts[bit] += starts[bit - 1];
+        }
+        for (auto row : rows) {
+            results[starts[std::countr_zero(columns.getWeeks(row))]++] = columns.getEntry(row);
+        }
+        return results;
+    }
+
+    for (auto entry : collect(candidates, week)) {
+        bool matchesModule = moduleCode.empty() || (entry->getModule()->getModuleSymbol() == module);
+        bool matchesRoom = roomID.empty() || (entry->getRoom()->getRoomSymbol() == room);
+        bool matchesLecturer = lecturerID.empty() || (entry->getLecturer()->getLecturerSymbol() == lecturer);
+
+        if (matchesModule && matchesRoom && matchesLecturer) {
+            results.push_back(entry);
+        }
+    }
+
+    return results;
+}
+
+std::vector<TimetableEntry*> TimetableVersion::getTimetableForGroup(std::string_view groupID, int week) const {
+    return collect(findList(groupIndex, groupID), week);
+}
+
+std::vector<TimetableEntry*> TimetableVersion::getTimetableForLecturer(std::string_view lecturerID, int week) const {
+    return collect(findList(lecturerIndex, lecturerID), week);
+}
+
+std::vector<TimetableEntry*> TimetableVersion::getTimetableForRoom(std::string_view roomID, int week) const {
+    return collect(findList(roomIndex, roomID), week);
+}
+
+const EntryColumns& TimetableVersion::getColumns() const {
+    return columns;
+}
+
+std::vector<TimetableEntry*> TimetableVersion::getEntries() const {
+    return columns.getEntries();
+}
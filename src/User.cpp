@@ -1,9 +1,10 @@
 
 #include "../include/User.h"
+#include "../include/GlobalVariables.h"
 #include <iostream>
 
 User::User(const std::string& id, const std::string& userName, const std::string& pwd)
-    : userID(id), name(userName), password(pwd) {
+    : userID(g_strings.intern(id)), name(g_strings.intern(userName)), password(pwd) {
 }
 
 bool User::authenticate(const std::string& attemptedPassword) const {
@@ -12,15 +13,21 @@ bool User::authenticate(const std::string& attemptedPassword) const {
 }
 
 std::string User::getUserDetails() const {
-    return "User ID: " + userID + ", Name: " + name;
+    std::string details = "User ID: ";
+    details.append(getUserID()).append(", Name: ").append(getName());
+    return details;
 }
 
-std::string User::getUserID() const {
+std::string_view User::getUserID() const {
+    return g_strings.view(userID);
+}
+
+StringInterner::Symbol User::getUserSymbol() const {
     return userID;
 }
 
-std::string User::getName() const {
-    return name;
+std::string_view User::getName() const {
+    return g_strings.view(name);
 }
 
 bool User::changePassword(const std::string& oldPassword, const std::string& newPassword) {
@@ -1,24 +1,32 @@
 
 
 #include "../include/UserManager.h"
+#include "../include/GlobalVariables.h"
 #include <algorithm>
 
 UserManager::UserManager() {
 }
 
 UserManager::~UserManager() {
-    // Clean up all user objects
-    for (auto user : users) {
-        delete user;
+    // Clean up admin objects; students belong to the registry
+    for (auto admin : admins) {
+        delete admin;
     }
-    users.clear();
+    admins.clear();
+}
+
+bool UserManager::addAdmin(Admin* admin) {
+    if (!adminsByID.insert(admin->getUserID(), admin)) {
+        return false;
+    }
+    admins.push_back(admin);
+    return true;
 }
 
 User* UserManager::authenticate(const std::string& userId, const std::string& password) const {
-    for (auto user : users) {
-        if (user->getUserID() == userId && user->authenticate(password)) {
-            return user;
-        }
+    User* user = getUserById(userId);
+    if (user && user->authenticate(password)) {
+        return user;
     }
 
     return nullptr; // Authentication failed
@@ -33,7 +41,11 @@ Admin* UserManager::registerAdmin(const std::string& id, const std::string& name
 
     // Create new admin user
     Admin* admin = new Admin(id, name, password, department);
-    users.push_back(admin);
+    addAdmin(admin);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::RegisterAdmin)
+                              .str(id).str(name).str(password).str(department));
+    }
 
     return admin;
 }
@@ -41,65 +53,55 @@ Admin* UserManager::registerAdmin(const std::string& id, const std::string& name
 Student* UserManager::registerStudent(const std::string& id, const std::string& name,
                                     const std::string& password, const std::string& studentNumber,
                                     const std::string& course) {
-    // Check if user ID already exists
-    if (getUserById(id) != nullptr) {
-        return nullptr; // User ID already exists
+    // Check if user ID or student number already exists
+    if (getUserById(id) != nullptr || g_registry.findStudentByNumber(studentNumber) != nullptr) {
+        return nullptr; // User ID or student number already exists
     }
 
-    // Create new student user
+    // Create new student user in the shared student store
     Student* student = new Student(id, name, password, studentNumber, course);
-    users.push_back(student);
+    g_registry.addStudent(student);
+    if (g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::RegisterStudent)
+                              .str(id).str(name).str(password).str(studentNumber).str(course));
+    }
 
     return student;
 }
 
 User* UserManager::getUserById(const std::string& userId) const {
-    for (auto user : users) {
-        if (user->getUserID() == userId) {
-            return user;
-        }
+    Admin* const* admin = adminsByID.find(userId);
+    if (admin) {
+        return *admin;
     }
 
-    return nullptr; // User not found
+    return g_registry.findStudent(userId); // nullptr if user not found
 }
 
-std::vector<Admin*> UserManager::getAllAdmins() const {
-    std::vector<Admin*> admins;
-
-    for (auto user : users) {
-        Admin* admin = dynamic_cast<Admin*>(user);
-        if (admin) {
-            admins.push_back(admin);
-        }
-    }
-
+const std::vector<Admin*>& UserManager::getAllAdmins() const {
     return admins;
 }
 
-std::vector<Student*> UserManager::getAllStudents() const {
-    std::vector<Student*> students;
-
-    for (auto user : users) {
-        Student* student = dynamic_cast<Student*>(user);
-        if (student) {
-            students.push_back(student);
-        }
-    }
-
-    return students;
+const std::vector<Student*>& UserManager::getAllStudents() const {
+    return g_registry.getStudents();
 }
 
 bool UserManager::deleteUser(const std::string& userId) {
-    auto it = std::find_if(users.begin(), users.end(),
-                           [&userId](const User* user) {
-                               return user->getUserID() == userId;
-                           });
-
-    if (it != users.end()) {
-        delete *it;
-        users.erase(it);
-        return true;
+    Admin* const* found = adminsByID.find(userId);
+    bool deleted = false;
+
+    if (found) {
+        Admin* admin = *found;
+        adminsByID.erase(userId);
+        admins.erase(std::find(admins.begin(), admins.end(), admin));
+        delete admin;
+        deleted = true;
+    } else {
+        deleted = g_registry.removeStudent(userId);
     }
 
-    return false;
+    if (deleted && g_journal) {
+        g_journal->append(JournalRecord(JournalRecord::Type::DeleteUser).str(userId));
+    }
+    return deleted;
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "../include/WeekSet.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <sstream>
+
+namespace {
+
+// Bits of weeks 1-53
+const std::uint64_t ALL_WEEKS = ((std::uint64_t(1) << (WeekSet::LAST_WEEK + 1)) - 1) & ~std::uint64_t(1);
+
+// Parses a whole field as a week number, allowing spaces around it
+bool parseWeek(std::string_view text, int& week) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+
+    auto result = std::from_chars(text.data(), text.data() + text.size(), week);
+    return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size() &&
+           week >= WeekSet::FIRST_WEEK && week <= WeekSet::LAST_WEEK;
+}
+
+}
+
+WeekSet::WeekSet(std::uint64_t mask) : bits(mask) {
+}
+
+WeekSet WeekSet::single(int week) {
+    WeekSet weeks;
+    weeks.add(week);
+    return weeks;
+}
+
+WeekSet WeekSet::range(int first, int last) {
+    WeekSet weeks;
+    for (int week = std::max(first, FIRST_WEEK); week <= std::min(last, LAST_WEEK); ++week) {
+        weeks.add(week);
+    }
+    return weeks;
+}
+
+bool WeekSet::parse(std::string_view text, WeekSet& weeks) {
+    WeekSet parsed;
+    while (true) {
+        size_t comma = text.find(',');
+        std::string_view item = text.substr(0, comma);
+
+        int first = 0, last = 0;
+        size_t dash = item.find('-');
+        if (dash == std::string_view::npos) {
+            if (!parseWeek(item, first)) {
+                return false;
+            }
+            last = first;
+        } else if (!parseWeek(item.substr(0, dash), first) || !parseWeek(item.substr(dash + 1), last) ||
+                   first > last) {
+            return false;
+        }
+        parsed.bits |= range(first, last).bits;
+
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+
+    weeks = parsed;
+    return true;
+}
+
+bool WeekSet::contains(int week) const {
+    return week >= FIRST_WEEK && week <= LAST_WEEK && (bits >> week & 1);
+}
+
+void WeekSet::add(int week) {
+    if (week >= FIRST_WEEK && week <= LAST_WEEK) {
+        bits |= std::uint64_t(1) << week;
+    }
+}
+
+void WeekSet::remove(int week) {
+    if (week >= FIRST_WEEK && week <= LAST_WEEK) {
+        bits &= ~(std::uint64_t(1) << week);
+    }
+}
+
+bool WeekSet::empty() const {
+    return bits == 0;
+}
+
+bool WeekSet::isValid() const {
+    return bits != 0 && (bits & ~ALL_WEEKS) == 0;
+}
+
+int WeekSet::count() const {
+    return std::popcount(bits);
+}
+
+int WeekSet::first() const {
+    return bits ? std::countr_zero(bits) : 0;
+}
+
+int WeekSet::next(int week) const {
+    std::uint64_t later = week >= 63 ? 0 : bits & (~std::uint64_t(0) << (week + 1));
+    return later ? std::countr_zero(later) : 0;
+}
+
+bool WeekSet::intersects(const WeekSet& other) const {
+    return (bits & other.bits) != 0;
+}
+
+std::uint64_t WeekSet::getBits() const {
+    return bits;
+}
+
+std::string WeekSet::toString() const {
+    if (bits == 0) {
+        return "none";
+    }
+
+    std::stringstream ss;
+    for (int week = first(); week; ) {
+        // Extend the run while the following week is also in the set
+        int last = week;
+        while (next(last) == last + 1) {
+            ++last;
+        }
+
+        ss << (week == first() ? "" : ", ") << week;
+        if (last > week) {
+            ss << "-" << last;
+        }
+        week = next(last);
+    }
+    return ss.str();
+}
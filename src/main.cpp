@@ -6,9 +6,19 @@
 #include <vector>
 #include <memory>
 #include <limits>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include <charconv>
+#include <csignal>
 
 #include "../include/UserManager.h"
 #include "../include/TimetableManager.h"
+#include "../include/TimetableGenerator.h"
+#include "../include/BatchRunner.h"
+#include "../include/QueryServer.h"
+#include "../include/Snapshot.h"
+#include "../include/Journal.h"
 #include "../include/Module.h"
 #include "../include/Room.h"
 #include "../include/SessionType.h"
@@ -17,8 +27,22 @@
 #include "../include/TimeSlot.h"
 #include "../include/GlobalVariables.h"
 
+// File the system state is saved to on exit and restored from at startup
+const std::string SNAPSHOT_FILE = "timetable.snapshot";
+
+// Changes made since the last snapshot, replayed on top of it at startup
+const std::string JOURNAL_FILE = "timetable.journal";
+
+// Port the query server listens on when none is given
+const unsigned short DEFAULT_SERVER_PORT = 8080;
+
+// Server to stop on Ctrl+C or SIGTERM in server mode
+QueryServer* runningServer = nullptr;
+
 // Function prototypes
 void initializeSystem(UserManager& userManager);
+void stopServer(int signal);
+bool saveState(const UserManager& userManager, const TimetableManager& timetableManager, std::uint64_t lastLSN);
 void displayMainMenu();
 void displayAdminMenu();
 void displayStudentMenu();
@@ -46,13 +70,111 @@ void waitForEnter();
 std::string getInputString(const std::string& prompt);
 int getInputInt(const std::string& prompt, int min = 0, int max = std::numeric_limits<int>::max());
 
-int main() {
+int main(int argc, char* argv[]) {
+    // "--batch [script]" runs a command script, read from standard input if no file is given,
+    // and "--serve [port]" answers timetable queries over HTTP until stopped
+    bool batch = argc > 1 && std::string(argv[1]) == "--batch";
+    bool serve = argc > 1 && std::string(argv[1]) == "--serve";
+    unsigned short port = DEFAULT_SERVER_PORT;
+    bool validPort = true;
+    if (serve && argc > 2) {
+        std::string_view text(argv[2]);
+        auto result = std::from_chars(text.data(), text.data() + text.size(), port);
+        validPort = result.ec == std::errc() && result.ptr == text.data() + text.size() && port != 0;
+    }
+    if (argc > (batch || serve ? 3 : 1) || !validPort) {
+        std::cout << "Usage: " << argv[0] << " [--batch [script] | --serve [port]]" << std::endl;
+        return 1;
+    }
+
     // Create managers
     UserManager userManager;
     TimetableManager timetableManager("2024-2025", "Spring");
 
-    // Initialize system with some test data
-    initializeSystem(userManager);
+    // Restore the saved state and any changes journaled after it
+    std::uint64_t snapshotLSN = 0;
+    Snapshot::LoadResult loaded = Snapshot::load(SNAPSHOT_FILE, userManager, timetableManager, &snapshotLSN);
+    if (loaded == Snapshot::LoadResult::Invalid) {
+        // Starting without it would replay the journal onto nothing and then save over the file
+        std::cout << "Error: " << SNAPSHOT_FILE << " exists but cannot be read; it may be damaged or from "
+                  << "another version. It has been left untouched. Restore or move it aside to start." << std::endl;
+        return 1;
+    }
+    bool restored = loaded == Snapshot::LoadResult::Loaded;
+    std::uint64_t lastLSN = snapshotLSN;
+    std::vector<std::string> setAside;
+    size_t replayed = Journal::replay(JOURNAL_FILE, snapshotLSN, userManager, timetableManager, lastLSN, &setAside);
+    for (const auto& segment : setAside) {
+        std::cout << "Warning: replay stopped at a damaged record; the unreplayed journal was kept as "
+                  << segment << "." << std::endl;
+    }
+    if (restored) {
+        std::cout << "Restored saved state from " << SNAPSHOT_FILE << "." << std::endl;
+    }
+    if (replayed > 0) {
+        std::cout << "Replayed " << replayed << " change(s) from " << JOURNAL_FILE << "." << std::endl;
+    }
+
+    // Replayed changes go into the snapshot first, since opening the journal starts it afresh
+    g_journal = new Journal(JOURNAL_FILE);
+    if ((replayed > 0 && !Snapshot::save(SNAPSHOT_FILE, userManager, timetableManager, lastLSN)) ||
+        !g_journal->open(lastLSN)) {
+        std::cout << "Warning: journaling is off; changes are only saved on exit." << std::endl;
+        delete g_journal;
+        g_journal = nullptr;
+    }
+
+    // Otherwise initialize system with some test data, saved at once since it is not journaled
+    // and later journal records refer to it
+    if (!restored && replayed == 0) {
+        initializeSystem(userManager);
+        saveState(userManager, timetableManager, lastLSN);
+    }
+
+    if (batch) {
+        std::ifstream file;
+        bool fromFile = argc > 2 && std::string(argv[2]) != "-";
+        if (fromFile) {
+            file.open(argv[2]);
+        }
+
+        bool succeeded = false;
+        if (fromFile && !file.is_open()) {
+            std::cout << "Failed to open batch script " << argv[2] << "." << std::endl;
+        } else {
+            BatchRunner runner(userManager, timetableManager, SNAPSHOT_FILE);
+            succeeded = runner.run(fromFile ? static_cast<std::istream&>(file) : std::cin);
+        }
+
+        saveState(userManager, timetableManager, lastLSN);
+        delete g_journal;
+        g_journal = nullptr;
+        g_registry.clear();
+        return succeeded ? 0 : 1;
+    }
+
+    if (serve) {
+        // The timetable is only read while serving, so nothing needs saving afterwards
+        QueryServer server(timetableManager, std::max(2u, std::thread::hardware_concurrency()));
+        bool listening = server.listen(port);
+        if (listening) {
+            std::cout << "Answering timetable queries on http://127.0.0.1:" << port
+                      << "/ (Ctrl+C to stop)." << std::endl;
+            runningServer = &server;
+            std::signal(SIGINT, stopServer);
+            std::signal(SIGTERM, stopServer);
+            server.serve();
+            runningServer = nullptr;
+            std::cout << "Server stopped after " << server.getRequestsServed() << " request(s)." << std::endl;
+        } else {
+            std::cout << "Failed to listen on port " << port << "." << std::endl;
+        }
+
+        delete g_journal;
+        g_journal = nullptr;
+        g_registry.clear();
+        return listening ? 0 : 1;
+    }
 
     // Main application loop
     bool running = true;
@@ -103,18 +225,19 @@ int main() {
                 break;
             }
             case 3:
+                saveState(userManager, timetableManager, lastLSN);
                 std::cout << "Exiting the system. Goodbye!" << std::endl;
                 running = false;
                 break;
         }
     }
 
+    // Stop journaling before the collections it describes are freed
+    delete g_journal;
+    g_journal = nullptr;
+
     // Clean up global collections
-    for (auto module : g_modules) delete module;
-    for (auto room : g_rooms) delete room;
-    for (auto sessionType : g_sessionTypes) delete sessionType;
-    for (auto lecturer : g_lecturers) delete lecturer;
-    for (auto group : g_studentGroups) delete group;
+    g_registry.clear();
 
     return 0;
 }
@@ -163,6 +286,25 @@ void initializeSystem(UserManager& userManager) {
     }
 }
 
+void stopServer(int) {
+    if (runningServer) {
+        runningServer->stop();
+    }
+}
+
+bool saveState(const UserManager& userManager, const TimetableManager& timetableManager, std::uint64_t lastLSN) {
+    // A background compaction must not replace this snapshot with an older one
+    if (g_journal) {
+        g_journal->waitForCompaction();
+        lastLSN = g_journal->getLastLSN();
+    }
+    if (!Snapshot::save(SNAPSHOT_FILE, userManager, timetableManager, lastLSN)) {
+        std::cout << "Warning: failed to save state to " << SNAPSHOT_FILE << "." << std::endl;
+        return false;
+    }
+    return true;
+}
+
 void displayMainMenu() {
     std::cout << "Main Menu:" << std::endl;
     std::cout << "1. Login" << std::endl;
@@ -237,6 +379,12 @@ void handleAdminOperations(Admin* admin, TimetableManager& timetableManager, Use
                 waitForEnter();
                 break;
         }
+
+        // Fold a long journal into a fresh snapshot between operations
+        if (g_journal && g_journal->needsCompaction() &&
+            !g_journal->compact(SNAPSHOT_FILE, userManager, timetableManager)) {
+            std::cout << "Warning: failed to compact " << JOURNAL_FILE << "." << std::endl;
+        }
     }
 }
 
@@ -282,7 +430,7 @@ void handleStudentManagement(Admin* admin, UserManager& userManager) {
 
     // Display existing students
     std::cout << "Existing Students:" << std::endl;
-    std::vector<Student*> students = userManager.getAllStudents();
+    const std::vector<Student*>& students = userManager.getAllStudents();
     if (students.empty()) {
         std::cout << "  No students registered yet." << std::endl;
     } else {
@@ -369,6 +517,10 @@ void handleStudentManagement(Admin* admin, UserManager& userManager) {
 
             bool success = student->changePassword(oldPassword, newPassword);
             if (success) {
+                if (g_journal) {
+                    g_journal->append(JournalRecord(JournalRecord::Type::ChangePassword)
+                                          .str(student->getUserID()).str(newPassword));
+                }
                 std::cout << "Student password updated successfully." << std::endl;
             } else {
                 std::cout << "Failed to update password. Current password may be incorrect." << std::endl;
@@ -385,12 +537,13 @@ void handleStudentManagement(Admin* admin, UserManager& userManager) {
 
             int studentIndex = getInputInt("Enter student number to delete: ", 1, students.size()) - 1;
             Student* student = students[studentIndex];
-            std::string studentID = student->getUserID();
+            std::string studentID(student->getUserID());
 
-            // Check if student is assigned to any groups and remove them
+            // Remove the student from every group; removeStudent finds them in one pass
             for (auto& group : g_studentGroups) {
-                if (group->hasStudent(studentID)) {
-                    group->removeStudent(studentID);
+                if (group->removeStudent(studentID) && g_journal) {
+                    g_journal->append(JournalRecord(JournalRecord::Type::RemoveStudentFromGroup)
+                                          .str(group->getGroupID()).str(studentID));
                 }
             }
 
@@ -467,6 +620,13 @@ void handleModuleManagement(Admin* admin) {
                 module->updateDescription(description);
             }
 
+            if (g_journal && (!title.empty() || !description.empty())) {
+                g_journal->append(JournalRecord(JournalRecord::Type::UpdateModule)
+                                      .str(module->getModuleCode())
+                                      .str(module->getTitle())
+                                      .str(module->getDescription()));
+            }
+
             std::cout << "Module updated: " << module->getDetails() << std::endl;
             waitForEnter();
             break;
@@ -479,11 +639,12 @@ void handleModuleManagement(Admin* admin) {
             }
 
             int index = getInputInt("Enter module number to delete: ", 1, g_modules.size()) - 1;
-            Module* module = g_modules[index];
-            std::string code = module->getModuleCode();
+            std::string code(g_modules[index]->getModuleCode());
 
-            g_modules.erase(g_modules.begin() + index);
-            delete module;
+            g_registry.removeModule(code);
+            if (g_journal) {
+                g_journal->append(JournalRecord(JournalRecord::Type::DeleteModule).str(code));
+            }
 
             std::cout << "Module " << code << " deleted." << std::endl;
             waitForEnter();
@@ -581,9 +742,13 @@ void handleStudentGroupManagement(Admin* admin) {
                     }
 
                     int studentIndex = getInputInt("Enter student number to remove: ", 1, students.size()) - 1;
-                    std::string studentID = students[studentIndex]->getUserID();
+                    std::string studentID(students[studentIndex]->getUserID());
 
                     bool success = group->removeStudent(studentID);
+                    if (success && g_journal) {
+                        g_journal->append(JournalRecord(JournalRecord::Type::RemoveStudentFromGroup)
+                                              .str(group->getGroupID()).str(studentID));
+                    }
                     if (success) {
                         std::cout << "Student removed from group successfully." << std::endl;
                     } else {
@@ -608,11 +773,12 @@ void handleStudentGroupManagement(Admin* admin) {
 
             int index = getInputInt("Enter group number to delete: ", 1, g_studentGroups.size()) - 1;
 
-            StudentGroup* group = g_studentGroups[index];
-            std::string groupID = group->getGroupID();
+            std::string groupID(g_studentGroups[index]->getGroupID());
 
-            g_studentGroups.erase(g_studentGroups.begin() + index);
-            delete group;
+            g_registry.removeStudentGroup(groupID);
+            if (g_journal) {
+                g_journal->append(JournalRecord(JournalRecord::Type::DeleteStudentGroup).str(groupID));
+            }
 
             std::cout << "Student group " << groupID << " deleted." << std::endl;
             waitForEnter();
@@ -677,6 +843,10 @@ void handleSessionTypeManagement(Admin* admin) {
 
             if (!typeName.empty()) {
                 sessionType->updateTypeName(typeName);
+                if (g_journal) {
+                    g_journal->append(JournalRecord(JournalRecord::Type::UpdateSessionType)
+                                          .str(sessionType->getTypeID()).str(typeName));
+                }
             }
 
             std::cout << "Session type updated: " << sessionType->getSessionDetails() << std::endl;
@@ -692,11 +862,12 @@ void handleSessionTypeManagement(Admin* admin) {
 
             int index = getInputInt("Enter session type number to delete: ", 1, g_sessionTypes.size()) - 1;
 
-            SessionType* sessionType = g_sessionTypes[index];
-            std::string typeID = sessionType->getTypeID();
+            std::string typeID(g_sessionTypes[index]->getTypeID());
 
-            g_sessionTypes.erase(g_sessionTypes.begin() + index);
-            delete sessionType;
+            g_registry.removeSessionType(typeID);
+            if (g_journal) {
+                g_journal->append(JournalRecord(JournalRecord::Type::DeleteSessionType).str(typeID));
+            }
 
             std::cout << "Session type " << typeID << " deleted." << std::endl;
             waitForEnter();
@@ -802,11 +973,12 @@ void handleLecturerManagement(Admin* admin) {
 
             int index = getInputInt("Enter lecturer number to delete: ", 1, g_lecturers.size()) - 1;
 
-            Lecturer* lecturer = g_lecturers[index];
-            std::string lecturerID = lecturer->getLecturerID();
+            std::string lecturerID(g_lecturers[index]->getLecturerID());
 
-            g_lecturers.erase(g_lecturers.begin() + index);
-            delete lecturer;
+            g_registry.removeLecturer(lecturerID);
+            if (g_journal) {
+                g_journal->append(JournalRecord(JournalRecord::Type::DeleteLecturer).str(lecturerID));
+            }
 
             std::cout << "Lecturer " << lecturerID << " deleted." << std::endl;
             waitForEnter();
@@ -865,11 +1037,12 @@ void handleRoomManagement(Admin* admin) {
 
             int index = getInputInt("Enter room number to delete: ", 1, g_rooms.size()) - 1;
 
-            Room* room = g_rooms[index];
-            std::string roomID = room->getRoomID();
+            std::string roomID(g_rooms[index]->getRoomID());
 
-            g_rooms.erase(g_rooms.begin() + index);
-            delete room;
+            g_registry.removeRoom(roomID);
+            if (g_journal) {
+                g_journal->append(JournalRecord(JournalRecord::Type::DeleteRoom).str(roomID));
+            }
 
             std::cout << "Room " << roomID << " deleted." << std::endl;
             waitForEnter();
@@ -901,9 +1074,13 @@ void handleTimetableManagement(Admin* admin, TimetableManager& timetableManager)
     std::cout << "Operations:" << std::endl;
     std::cout << "1. Create Timetable Entry" << std::endl;
     std::cout << "2. Delete Timetable Entry" << std::endl;
-    std::cout << "3. Back to Admin Menu" << std::endl;
+    std::cout << "3. Generate Timetable" << std::endl;
+    std::cout << "4. Import Timetable from CSV" << std::endl;
+    std::cout << "5. Export Timetable to CSV" << std::endl;
+    std::cout << "6. Find Free Slots" << std::endl;
+    std::cout << "7. Back to Admin Menu" << std::endl;
 
-    int choice = getInputInt("Enter your choice: ", 1, 3);
+    int choice = getInputInt("Enter your choice: ", 1, 7);
 
     switch (choice) {
         case 1: {
@@ -920,7 +1097,11 @@ void handleTimetableManagement(Admin* admin, TimetableManager& timetableManager)
                 break;
             }
 
-            int week = getInputInt("Enter week number (1-53): ", 1, 53);
+            // A session held in several weeks is entered once, e.g. "1-6, 8-12"
+            WeekSet weeks;
+            while (!WeekSet::parse(getInputString("Enter weeks (e.g. 5, or 1-6, 8-12): "), weeks)) {
+                std::cout << "Enter week numbers from 1 to 53, separated by commas, with ranges as first-last." << std::endl;
+            }
 
             // Select module
             std::cout << "Available modules:" << std::endl;
@@ -962,13 +1143,10 @@ void handleTimetableManagement(Admin* admin, TimetableManager& timetableManager)
             std::string startTime = getInputString("Enter start time (HH:MM): ");
             std::string endTime = getInputString("Enter end time (HH:MM): ");
 
-            // Create time slot
-            TimeSlot* timeSlot = new TimeSlot(day, startTime, endTime);
-
             // Create timetable entry
             bool success = admin->createTimetableEntry(
                 timetableManager,
-                week,
+                weeks,
                 g_modules[moduleIndex]->getModuleCode(),
                 g_lecturers[lecturerIndex]->getLecturerID(),
                 g_rooms[roomIndex]->getRoomID(),
@@ -983,7 +1161,6 @@ void handleTimetableManagement(Admin* admin, TimetableManager& timetableManager)
                 std::cout << "Timetable entry created successfully." << std::endl;
             } else {
                 std::cout << "Failed to create timetable entry. Check for conflicts." << std::endl;
-                delete timeSlot; // Clean up if creation failed
             }
             waitForEnter();
             break;
@@ -996,7 +1173,7 @@ void handleTimetableManagement(Admin* admin, TimetableManager& timetableManager)
             }
 
             int index = getInputInt("Enter timetable entry number to delete: ", 1, entries.size()) - 1;
-            std::string entryID = entries[index]->getEntryID();
+            std::string entryID(entries[index]->getEntryID());
 
             bool success = timetableManager.deleteEntry(entryID);
             if (success) {
@@ -1007,7 +1184,198 @@ void handleTimetableManagement(Admin* admin, TimetableManager& timetableManager)
             waitForEnter();
             break;
         }
-        case 3:
+        case 3: {
+            if (g_modules.empty() || g_lecturers.empty() || g_rooms.empty() ||
+                g_studentGroups.empty() || g_sessionTypes.empty()) {
+                std::cout << "Cannot generate timetable. Modules, lecturers, rooms, student groups "
+                          << "and session types must all be defined." << std::endl;
+                waitForEnter();
+                break;
+            }
+
+            GenerationOptions options;
+            int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+            options.threads = getInputInt("Enter number of search threads (1-" + std::to_string(maxThreads) + "): ",
+                                          1, maxThreads);
+            TimetableGenerator generator(timetableManager, g_rooms, options);
+
+            bool addingDemands = true;
+            while (addingDemands) {
+                std::cout << "Session demand " << (generator.getDemands().size() + 1) << ":" << std::endl;
+
+                std::cout << "Available modules:" << std::endl;
+                for (size_t i = 0; i < g_modules.size(); ++i) {
+                    std::cout << "  " << (i+1) << ". " << g_modules[i]->getDetails() << std::endl;
+                }
+                int moduleIndex = getInputInt("Select module: ", 1, g_modules.size()) - 1;
+
+                std::cout << "Available lecturers:" << std::endl;
+                for (size_t i = 0; i < g_lecturers.size(); ++i) {
+                    std::cout << "  " << (i+1) << ". " << g_lecturers[i]->getDetails() << std::endl;
+                }
+                int lecturerIndex = getInputInt("Select lecturer: ", 1, g_lecturers.size()) - 1;
+
+                std::cout << "Available student groups:" << std::endl;
+                for (size_t i = 0; i < g_studentGroups.size(); ++i) {
+                    std::cout << "  " << (i+1) << ". " << g_studentGroups[i]->getDetails() << std::endl;
+                }
+                int groupIndex = getInputInt("Select student group: ", 1, g_studentGroups.size()) - 1;
+
+                std::cout << "Available session types:" << std::endl;
+                for (size_t i = 0; i < g_sessionTypes.size(); ++i) {
+                    std::cout << "  " << (i+1) << ". " << g_sessionTypes[i]->getSessionDetails() << std::endl;
+                }
+                int sessionTypeIndex = getInputInt("Select session type: ", 1, g_sessionTypes.size()) - 1;
+
+                SessionDemand demand;
+                demand.module = g_modules[moduleIndex];
+                demand.lecturer = g_lecturers[lecturerIndex];
+                demand.studentGroup = g_studentGroups[groupIndex];
+                demand.sessionType = g_sessionTypes[sessionTypeIndex];
+                demand.sessionsPerWeek = getInputInt("Enter sessions per week: ", 1, 10);
+                demand.durationMinutes = getInputInt("Enter session length in minutes: ", 1, 540);
+                demand.capacityNeeded = getInputInt("Enter number of seats needed: ", 0);
+                demand.firstWeek = getInputInt("Enter first week (1-53): ", 1, 53);
+                demand.lastWeek = getInputInt("Enter last week (first week-53): ", demand.firstWeek, 53);
+
+                if (!generator.addDemand(demand)) {
+                    std::cout << "Session demand rejected. Sessions must fit between 09:00 and 18:00." << std::endl;
+                }
+
+                addingDemands = getInputString("Add another session demand? (y/n): ") == "y";
+            }
+
+            if (generator.getDemands().empty()) {
+                std::cout << "No session demands to schedule." << std::endl;
+                waitForEnter();
+                break;
+            }
+
+            GenerationStats stats = generator.generate();
+            std::cout << "Placed " << stats.sessionsPlaced << " of " << stats.sessionsRequested
+                      << " weekly sessions (" << stats.entriesCreated << " timetable entries created)." << std::endl;
+            if (stats.sessionsPlaced < stats.sessionsRequested) {
+                std::cout << "Some sessions could not be placed without a conflict." << std::endl;
+            }
+            std::cout << "Soft cost: " << stats.softCost << std::endl;
+            std::cout << "Construction: " << stats.constructionSeconds << "s ("
+                      << stats.placementsPerSecond << " placements/s), improvement: "
+                      << stats.improvementSeconds << "s (" << stats.movesPerSecond << " moves/s on "
+                      << stats.threadsUsed << " threads), total: " << stats.totalSeconds << "s" << std::endl;
+            waitForEnter();
+            break;
+        }
+        case 4: {
+            std::string filename = getInputString("Enter filename to import (e.g., timetable.csv): ");
+
+            ImportSummary summary;
+            bool success = timetableManager.importFromCSV(filename, g_modules, g_lecturers, g_rooms,
+                                                          g_studentGroups, g_sessionTypes, &summary);
+            if (success) {
+                std::cout << "Imported " << summary.entriesImported << " of " << summary.rowsRead
+                          << " timetable entries from " << filename << "." << std::endl;
+                if (summary.rowsSkipped > 0) {
+                    std::cout << summary.rowsSkipped << " rows were skipped (malformed, unknown references, "
+                              << "duplicate IDs or double bookings)." << std::endl;
+                }
+                if (timetableManager.hasConflicts()) {
+                    std::cout << "The imported timetable has conflicts. See Conflict Detection." << std::endl;
+                }
+            } else {
+                std::cout << "Failed to import timetable. Check the file exists and has the export header." << std::endl;
+            }
+            waitForEnter();
+            break;
+        }
+        case 5: {
+            std::string filename = getInputString("Enter filename for export (e.g., timetable.csv): ");
+
+            if (timetableManager.exportToCSV(filename)) {
+                std::cout << "Timetable exported successfully to " << filename << "." << std::endl;
+            } else {
+                std::cout << "Failed to export timetable." << std::endl;
+            }
+            waitForEnter();
+            break;
+        }
+        case 6: {
+            if (g_modules.empty() || g_lecturers.empty() || g_rooms.empty() ||
+                g_studentGroups.empty() || g_sessionTypes.empty()) {
+                std::cout << "Cannot search for free slots. Modules, lecturers, rooms, student groups "
+                          << "and session types must all be defined." << std::endl;
+                waitForEnter();
+                break;
+            }
+
+            SlotQuery query;
+
+            std::cout << "Available lecturers:" << std::endl;
+            for (size_t i = 0; i < g_lecturers.size(); ++i) {
+                std::cout << "  " << (i+1) << ". " << g_lecturers[i]->getDetails() << std::endl;
+            }
+            query.lecturer = g_lecturers[getInputInt("Select lecturer: ", 1, g_lecturers.size()) - 1];
+
+            std::cout << "Available student groups:" << std::endl;
+            for (size_t i = 0; i < g_studentGroups.size(); ++i) {
+                std::cout << "  " << (i+1) << ". " << g_studentGroups[i]->getDetails() << std::endl;
+            }
+            query.group = g_studentGroups[getInputInt("Select student group: ", 1, g_studentGroups.size()) - 1];
+
+            query.minCapacity = getInputInt("Enter number of seats needed: ", 0);
+            query.durationMinutes = getInputInt("Enter session length in minutes: ", 1, 540);
+            query.firstWeek = getInputInt("Enter first week (1-53): ", 1, 53);
+            query.lastWeek = getInputInt("Enter last week (first week-53): ", query.firstWeek, 53);
+            query.limit = getInputInt("Enter number of options to show (1-50): ", 1, 50);
+
+            std::vector<SlotOption> options = timetableManager.findFreeSlots(query, g_rooms);
+            if (options.empty()) {
+                std::cout << "No room and time between 09:00 and 18:00 is free in every week of that range." << std::endl;
+                waitForEnter();
+                break;
+            }
+
+            std::cout << "Best options:" << std::endl;
+            for (size_t i = 0; i < options.size(); ++i) {
+                std::cout << "  " << (i+1) << ". " << options[i].timeSlot.getTimeSlotDetails()
+                          << " in " << options[i].room->getRoomID()
+                          << " (capacity " << options[i].room->getCapacity()
+                          << ", score " << options[i].score << ")" << std::endl;
+            }
+
+            int optionIndex = getInputInt("Enter option number to book (0 to cancel): ", 0, options.size()) - 1;
+            if (optionIndex < 0) {
+                break;
+            }
+
+            std::cout << "Available modules:" << std::endl;
+            for (size_t i = 0; i < g_modules.size(); ++i) {
+                std::cout << "  " << (i+1) << ". " << g_modules[i]->getDetails() << std::endl;
+            }
+            Module* module = g_modules[getInputInt("Select module: ", 1, g_modules.size()) - 1];
+
+            std::cout << "Available session types:" << std::endl;
+            for (size_t i = 0; i < g_sessionTypes.size(); ++i) {
+                std::cout << "  " << (i+1) << ". " << g_sessionTypes[i]->getSessionDetails() << std::endl;
+            }
+            SessionType* sessionType = g_sessionTypes[getInputInt("Select session type: ", 1, g_sessionTypes.size()) - 1];
+
+            // The option is free in every week of the range, so it is booked as one recurring entry
+            const SlotOption& chosen = options[optionIndex];
+            bool success = admin->createTimetableEntry(timetableManager, WeekSet::range(query.firstWeek, query.lastWeek),
+                                                       module->getModuleCode(), query.lecturer->getLecturerID(),
+                                                       chosen.room->getRoomID(), query.group->getGroupID(),
+                                                       sessionType->getTypeID(), chosen.timeSlot.getDay(),
+                                                       chosen.timeSlot.getStartTime(), chosen.timeSlot.getEndTime());
+
+            if (success) {
+                std::cout << "Timetable entry created successfully." << std::endl;
+            } else {
+                std::cout << "Failed to create timetable entry. The slot may have been taken since the search." << std::endl;
+            }
+            waitForEnter();
+            break;
+        }
+        case 7:
             // Return to Admin Menu
             break;
     }
@@ -1018,25 +1386,15 @@ void handleConflictDetection(Admin* admin, TimetableManager& timetableManager) {
     std::cout << "Conflict Detection" << std::endl;
     std::cout << "------------------" << std::endl;
 
-    // Check for conflicts
-    timetableManager.checkForConflicts();
-
-    if (timetableManager.hasConflicts()) {
-        std::cout << "Conflicts detected:" << std::endl;
-
-        auto conflicts = timetableManager.getConflicts();
-        for (size_t i = 0; i < conflicts.size(); ++i) {
-            std::cout << "Conflict " << (i+1) << ":" << std::endl;
-            std::cout << "  1. " << conflicts[i].first->getEntryDetails() << std::endl;
-            std::cout << "  2. " << conflicts[i].second->getEntryDetails() << std::endl;
-
-            std::cout << "  Possible resolution: Reschedule one of the sessions to a different time or room." << std::endl;
-
-            std::cout << std::endl;
-        }
+    // Conflicts are tracked as entries change; compare them with a full rescan before rebuilding them
+    if (timetableManager.verifyConflicts()) {
+        std::cout << "Tracked conflicts match a full rescan." << std::endl;
     } else {
-        std::cout << "No conflicts detected in the timetable." << std::endl;
+        std::cout << "Tracked conflicts differ from a full rescan; rebuilding them." << std::endl;
     }
+    std::cout << std::endl;
+
+    admin->checkForConflicts(timetableManager);
 
     waitForEnter();
 }